@@ -30,6 +30,9 @@ var _drag_start_mouse_pos: Vector2
 var _manager: ObjectDragManager  # 管理器引用
 var _size_update_timer: Timer
 
+# 所有ObjectDragHandle共享的原生不透明度位图缓存(AlphaMaskCache)
+static var _alpha_mask_cache = null
+
 # 鼠标事件状态
 var _mouse_is_over: bool = false
 var _last_mouse_position: Vector2 = Vector2.ZERO
@@ -52,6 +55,10 @@ func _ready():
 	if Engine.is_editor_hint():
 		return
 	
+	# 创建共享的不透明度位图缓存，避免每次鼠标移动都读取纹理图像
+	if _alpha_mask_cache == null and ClassDB.class_exists("AlphaMaskCache"):
+		_alpha_mask_cache = ClassDB.instantiate("AlphaMaskCache")
+	
 	# 设置初始大小
 	if auto_size_enabled:
 		_update_size_to_fit_children()
@@ -101,6 +108,8 @@ func update_drag_from_manager(global_pos: Vector2):
 	var parent = get_parent()
 	if parent:
 		parent.position = new_position
+		if _manager:
+			_manager.notify_handle_rect_changed(self)
 		dragging.emit(parent.position)
 	else:
 		push_warning("ObjectDragHandle: 没有父节点，无法拖拽")
@@ -229,6 +238,10 @@ func _update_size_to_fit_children():
 		if size != new_size:
 			size = new_size
 			size_changed.emit(new_size)
+	
+	# 通知管理器增量更新空间索引（区域未变化时索引内部直接跳过）
+	if _manager:
+		_manager.notify_handle_rect_changed(self)
 
 ## 获取子节点的显示区域
 func _get_child_display_rect(child: Node) -> Rect2:
@@ -391,6 +404,10 @@ func _check_sprite2d_opacity(sprite: Sprite2D, local_pos: Vector2) -> bool:
 	if texture_pos.x < 0 or texture_pos.x >= texture_size.x or texture_pos.y < 0 or texture_pos.y >= texture_size.y:
 		return false
 	
+	# 优先使用位图缓存，O(1)查询且不分配内存
+	if _alpha_mask_cache:
+		return _alpha_mask_cache.is_opaque(sprite.texture, Vector2i(texture_pos), opacity_threshold)
+	
 	# 获取像素并检查透明度
 	var image = sprite.texture.get_image()
 	if image:
@@ -426,6 +443,9 @@ func _check_animated_sprite2d_opacity(anim_sprite: AnimatedSprite2D, local_pos:
 	if texture_pos.x < 0 or texture_pos.x >= texture_size.x or texture_pos.y < 0 or texture_pos.y >= texture_size.y:
 		return false
 	
+	if _alpha_mask_cache:
+		return _alpha_mask_cache.is_opaque(current_texture, Vector2i(texture_pos), opacity_threshold)
+	
 	var image = current_texture.get_image()
 	if image:
 		var pixel_color = image.get_pixel(int(texture_pos.x), int(texture_pos.y))
@@ -488,6 +508,18 @@ func _recursive_find_window_drag_handles(node: Node, results: Array):
 ## 工具方法
 func set_manager(manager: ObjectDragManager):
 	_manager = manager
+	# 父节点变换、动画或其他脚本移动handle时也要更新管理器的空间索引
+	set_notify_transform(manager != null)
+	if manager and not item_rect_changed.is_connected(_on_item_rect_changed):
+		item_rect_changed.connect(_on_item_rect_changed)
+
+func _notification(what):
+	if what == NOTIFICATION_TRANSFORM_CHANGED:
+		_on_item_rect_changed()
+
+func _on_item_rect_changed():
+	if _manager and is_instance_valid(_manager):
+		_manager.notify_handle_rect_changed(self)
 
 func is_dragging() -> bool:
 	return _is_dragging
@@ -534,6 +566,8 @@ func set_manual_size(new_size: Vector2):
 	if not auto_size_enabled:
 		size = new_size
 		size_changed.emit(new_size)
+		if _manager:
+			_manager.notify_handle_rect_changed(self)
 
 func refresh_size():
 	"""手动刷新大小"""
@@ -542,6 +576,9 @@ func refresh_size():
 
 ## 清理
 func _exit_tree():
+	if _manager and is_instance_valid(_manager):
+		_manager.notify_handle_removed(self)
+	
 	if _size_update_timer:
 		_size_update_timer.queue_free()
 		_size_update_timer = null
@@ -14,6 +14,15 @@ var _current_dragging_handle: ObjectDragHandle = null
 # 鼠标事件状态跟踪
 var _current_hover_handle: ObjectDragHandle = null
 
+# 原生空间索引(UniWinSpatialGrid)，按位置查找候选handle，不指定类型避免编译时依赖
+var _spatial_index = null
+var _handles_by_id: Dictionary = {}
+# handle实例ID -> 场景树先序遍历中的位置（get_index()只是兄弟节点之间的顺序）
+var _tree_order: Dictionary = {}
+# 没有空间索引时使用：handle实例ID -> 排序时的z_index，z_index变化后才重新排序
+var _sorted_z_indices: Dictionary = {}
+var _handles_order_dirty: bool = false
+
 ## 初始化
 func _ready():
 	# 设置为全屏接收所有鼠标事件
@@ -27,6 +36,10 @@ func _ready():
 	# 查找主控制器（复用window_drag_handle.gd的逻辑）
 	_find_main_window_controller()
 	
+	# 创建空间索引，避免每次鼠标移动都线性扫描所有handle
+	if ClassDB.class_exists("UniWinSpatialGrid"):
+		_spatial_index = ClassDB.instantiate("UniWinSpatialGrid")
+	
 	# 延迟收集所有ObjectDragHandle，确保场景完全加载
 	call_deferred("_collect_drag_handles")
 
@@ -63,16 +76,25 @@ func _find_wrapper_node(node: Node):
 ## 收集所有ObjectDragHandle并设置它们
 func _collect_drag_handles():
 	object_drag_handles.clear()
+	_tree_order.clear()
 	_recursive_find_drag_handles(self)
 	
 	# 按优先级排序：Z-index高的优先，场景树中后添加的优先
-	object_drag_handles.sort_custom(_compare_drag_handles)
+	_sort_drag_handles()
+	
+	# 重建空间索引
+	_handles_by_id.clear()
+	if _spatial_index:
+		_spatial_index.clear()
+	for handle in object_drag_handles:
+		notify_handle_rect_changed(handle)
 	
 	print("ObjectDragManager: 发现 ", object_drag_handles.size(), " 个ObjectDragHandle")
 
 func _recursive_find_drag_handles(node: Node):
 	if node is ObjectDragHandle:
 		object_drag_handles.append(node)
+		_tree_order[node.get_instance_id()] = _tree_order.size()
 		# 禁用ObjectDragHandle的事件处理
 		node.mouse_filter = Control.MOUSE_FILTER_IGNORE
 		# 设置管理器引用
@@ -86,8 +108,18 @@ func _compare_drag_handles(a: ObjectDragHandle, b: ObjectDragHandle) -> bool:
 	# Z-index高的优先
 	if a.z_index != b.z_index:
 		return a.z_index > b.z_index
-	# 场景树中后添加的优先
-	return a.get_index() > b.get_index()
+	# 场景树中靠后的优先
+	return _get_tree_order(a) > _get_tree_order(b)
+
+func _sort_drag_handles():
+	object_drag_handles.sort_custom(_compare_drag_handles)
+	_sorted_z_indices.clear()
+	for handle in object_drag_handles:
+		_sorted_z_indices[handle.get_instance_id()] = handle.z_index
+	_handles_order_dirty = false
+
+func _get_tree_order(handle: ObjectDragHandle) -> int:
+	return _tree_order.get(handle.get_instance_id(), -1)
 
 ## 核心事件处理逻辑
 func _gui_input(event: InputEvent):
@@ -117,9 +149,8 @@ func _handle_mouse_button_event(event: InputEventMouseButton):
 		_current_hover_handle.handle_mouse_event_from_manager(event, local_pos)
 
 func _handle_drag_start(global_pos: Vector2):
-	# 依次检查每个ObjectDragHandle（按优先级）
-	for i in range(object_drag_handles.size()):
-		var handle = object_drag_handles[i]
+	# 依次检查每个候选ObjectDragHandle（按优先级）
+	for handle in _get_candidate_handles(global_pos):
 		if _should_handle_drag(handle, global_pos):
 			_current_dragging_handle = handle
 			handle.start_drag_from_manager(global_pos)
@@ -145,7 +176,7 @@ func _update_hover_state(global_pos: Vector2):
 	var new_hover_handle: ObjectDragHandle = null
 	
 	# 按优先级查找当前鼠标位置对应的 handle
-	for handle in object_drag_handles:
+	for handle in _get_candidate_handles(global_pos):
 		if _should_handle_mouse_event(handle, global_pos):
 			new_hover_handle = handle
 			break
@@ -162,6 +193,48 @@ func _update_hover_state(global_pos: Vector2):
 		
 		_current_hover_handle = new_hover_handle
 
+## 获取包含该位置的候选handle（已按优先级排序）
+func _get_candidate_handles(global_pos: Vector2) -> Array:
+	if not _spatial_index:
+		if _handles_order_dirty:
+			_sort_drag_handles()
+		return object_drag_handles
+	
+	var candidates = []
+	for id in _spatial_index.query_point(global_pos):
+		var handle = _handles_by_id.get(id)
+		if is_instance_valid(handle):
+			candidates.append(handle)
+	# z_index变化没有通知，索引中的顺序可能过时，按当前值重新排序（候选通常只有几个）
+	candidates.sort_custom(_compare_drag_handles)
+	return candidates
+
+## handle的区域变化时由ObjectDragHandle调用，增量更新空间索引
+func notify_handle_rect_changed(handle: ObjectDragHandle):
+	if not is_instance_valid(handle):
+		return
+	var id = handle.get_instance_id()
+	if not _spatial_index:
+		# 只有z_index变化时才需要重新排序，下一次查询时进行
+		if _sorted_z_indices.get(id, handle.z_index) != handle.z_index:
+			_handles_order_dirty = true
+		return
+	_handles_by_id[id] = handle
+	_spatial_index.update_item(id, Rect2(handle.global_position, handle.size), handle.z_index, _get_tree_order(handle))
+
+func notify_handle_removed(handle: ObjectDragHandle):
+	var id = handle.get_instance_id()
+	_handles_by_id.erase(id)
+	_tree_order.erase(id)
+	_sorted_z_indices.erase(id)
+	object_drag_handles.erase(handle)
+	if _spatial_index:
+		_spatial_index.remove_item(id)
+	if _current_hover_handle == handle:
+		_current_hover_handle = null
+	if _current_dragging_handle == handle:
+		_current_dragging_handle = null
+
 func _get_local_position(handle: ObjectDragHandle, global_pos: Vector2) -> Vector2:
 	# 将全局坐标转换为handle的本地坐标
 	var handle_global_pos = handle.global_position
@@ -7,10 +7,15 @@ class_name UniWindowControllerWrapper
 
 ## 信号定义
 signal files_dropped(files: PackedStringArray)
+signal files_dropped_chunk(files: PackedStringArray, chunk_index: int, is_last: bool)
+signal files_dropped_resolved(entries: Array)
 signal window_focus_changed(focused: bool)
 signal window_moved(position: Vector2)
 signal window_resized(size: Vector2)
 signal monitor_changed(monitor_index: int)
+signal fit_completed(monitor_index: int, success: bool)
+signal window_attached(attempt_count: int, frame_count: int)
+signal attach_failed(attempt_count: int, frame_count: int)
 
 ## Inspector中显示的属性 - 严格按照Unity版本的顺序和分组
 
@@ -39,7 +44,19 @@ signal monitor_changed(monitor_index: int)
 @export var auto_switch_camera_background: bool = true : set = _set_auto_switch_camera_background
 @export var force_windowed: bool = false : set = _set_force_windowed
 @export var hide_until_init_finished: bool = false
+## 窗口尚未就绪时在之后的帧按退避间隔重试附加，不阻塞启动的最初几帧
+@export var async_attach: bool = true
 @export var current_camera: Camera3D : set = _set_current_camera
+## 像素回读延迟帧数：0为同步回读，>0使用之前帧的结果以避免阻塞渲染线程（实际延迟不小于渲染设备的在途帧数）
+@export_range(0, 7) var hit_test_readback_latency: int = 2 : set = _set_hit_test_readback_latency
+## 每帧只发出一次window_moved/window_resized（最新的位置和大小），关闭后逐个事件发出
+@export var coalesce_window_events: bool = true : set = _set_coalesce_window_events
+## 拖放文件数超过该值时分多帧发出files_dropped_chunk，0为不分块
+@export_range(0, 100000, 1, "or_greater") var drop_chunk_size: int = 0 : set = _set_drop_chunk_size
+## 在后台线程解析拖放文件的类型、大小和修改时间，完成后发出files_dropped_resolved
+@export var resolve_dropped_files: bool = false : set = _set_resolve_dropped_files
+## 拖放目录的展开深度，0为不展开
+@export_range(0, 32) var drop_resolve_depth: int = 0 : set = _set_drop_resolve_depth
 
 @export_group("For Windows Only")
 @export_enum("None", "Alpha", "ColorKey") var transparent_type: int = 1 : set = _set_transparent_type
@@ -58,13 +75,17 @@ signal monitor_changed(monitor_index: int)
 var _native_controller  # 不指定类型，避免编译时依赖
 var _is_window_attached: bool = false
 var _setting_properties: bool = false  # 防止setter递归调用
-var _hit_test_texture: ImageTexture  # 用于像素检测的纹理
+var _hit_tester  # 原生像素检测器(UniWinHitTester)，不指定类型避免编译时依赖
 var _is_checking_hit_test: bool = false  # 是否正在进行点击测试
 var _internal_on_object: bool = true  # 内部状态，对应Unity的onObject
 var _internal_picked_color: Color = Color.WHITE  # 内部状态，对应Unity的pickedColor
 var _hidden_position: Vector2  # 用于hide_until_init_finished功能的临时隐藏位置
 var _target_position: Vector2  # 目标位置，用于恢复
 var _is_temporarily_hidden: bool = false  # 是否正在临时隐藏
+var _startup_ready_begin_usec: int = 0  # 启动时间线：_ready的开始和结束（Time.get_ticks_usec）
+var _startup_ready_end_usec: int = 0
+var _pending_attach_apply: bool = false  # 异步附加完成后再应用设置
+var _finish_trace_on_attach: bool = false  # 启动时间线等异步附加结果后结束
 
 ## Inspector属性的setter函数 - 严格按照Unity版本的属性名
 
@@ -214,6 +235,31 @@ func _set_current_camera(value: Camera3D):
 		return
 	current_camera = value
 
+func _set_hit_test_readback_latency(value: int):
+	hit_test_readback_latency = clamp(value, 0, 7)
+	if _hit_tester:
+		_hit_tester.readback_latency = hit_test_readback_latency
+
+func _set_coalesce_window_events(value: bool):
+	coalesce_window_events = value
+	if _native_controller:
+		_native_controller.coalesce_window_events = value
+
+func _set_drop_chunk_size(value: int):
+	drop_chunk_size = max(value, 0)
+	if _native_controller:
+		_native_controller.drop_chunk_size = drop_chunk_size
+
+func _set_resolve_dropped_files(value: bool):
+	resolve_dropped_files = value
+	if _native_controller and "resolve_dropped_files" in _native_controller:
+		_native_controller.resolve_dropped_files = value
+
+func _set_drop_resolve_depth(value: int):
+	drop_resolve_depth = max(value, 0)
+	if _native_controller and "drop_resolve_depth" in _native_controller:
+		_native_controller.drop_resolve_depth = drop_resolve_depth
+
 # Windows专用设置
 func _set_transparent_type(value: int):
 	if _setting_properties:
@@ -256,6 +302,7 @@ func _ready():
 	# 在编辑器中不执行运行时逻辑
 	if Engine.is_editor_hint():
 		return
+	_startup_ready_begin_usec = Time.get_ticks_usec()
 	
 	# hide_until_init_finished 功能：立即隐藏窗口
 	if hide_until_init_finished:
@@ -265,8 +312,12 @@ func _ready():
 			if temp_controller and temp_controller.attach_window():
 				_hide_window_temporarily_early(temp_controller)
 				temp_controller.detach_window()
+			# 临时控制器不在场景树中，不会分发native事件队列，用完立即释放
+			if temp_controller:
+				temp_controller.free()
 		
 	# 延迟初始化，确保GDExtension已加载
+	_startup_ready_end_usec = Time.get_ticks_usec()
 	call_deferred("_initialize_controller")
 
 ## 每帧更新 - 对应Unity版本的Update()方法
@@ -282,6 +333,8 @@ func _process(delta):
 	_update_click_through()
 
 func _initialize_controller():
+	var initialize_begin_usec = Time.get_ticks_usec()
+	
 	# 检查GDExtension是否可用
 	if not ClassDB.class_exists("UniWindowController"):
 		push_error("UniWinC GDExtension 未加载！请确保插件已正确安装。")
@@ -292,6 +345,15 @@ func _initialize_controller():
 	if not _native_controller:
 		push_error("无法创建 UniWindowController 实例")
 		return
+	
+	# 必须作为内部子节点加入场景树：native回调只写入事件队列，
+	# 由控制器的_process在主线程分发，不在树中时信号永远不会发出
+	add_child(_native_controller, false, Node.INTERNAL_MODE_FRONT)
+	_native_controller.coalesce_window_events = coalesce_window_events
+	_native_controller.drop_chunk_size = drop_chunk_size
+	if "resolve_dropped_files" in _native_controller:
+		_native_controller.resolve_dropped_files = resolve_dropped_files
+		_native_controller.drop_resolve_depth = drop_resolve_depth
 		
 	
 	# 连接信号
@@ -299,7 +361,26 @@ func _initialize_controller():
 	
 	# 等待更长时间确保窗口完全准备好，然后应用设置
 	if auto_attach:
+		var apply_begin_usec = Time.get_ticks_usec()
 		_apply_settings()
+		_record_startup_phase("_apply_settings", apply_begin_usec, Time.get_ticks_usec())
+	
+	# 启动完成：补记脚本各阶段并结束启动时间线
+	_record_startup_phase("UniWindowController.gd _ready", _startup_ready_begin_usec, _startup_ready_end_usec)
+	_record_startup_phase("deferred _initialize_controller", _startup_ready_end_usec, initialize_begin_usec)
+	_record_startup_phase("_initialize_controller", initialize_begin_usec, Time.get_ticks_usec())
+	if _pending_attach_apply:
+		_finish_trace_on_attach = true
+	else:
+		_finish_startup_trace()
+
+func _finish_startup_trace():
+	if _native_controller.has_method("finish_startup_trace"):
+		_native_controller.finish_startup_trace()
+
+func _record_startup_phase(phase_name: String, begin_usec: int, end_usec: int):
+	if _native_controller and _native_controller.has_method("add_startup_phase"):
+		_native_controller.add_startup_phase(phase_name, begin_usec, end_usec)
 
 func _connect_signals():
 	if not _native_controller:
@@ -307,23 +388,60 @@ func _connect_signals():
 	
 	# 直接连接信号 - 如果信号不存在会直接报错，这样更容易发现问题
 	_native_controller.files_dropped.connect(_on_files_dropped)
+	if _native_controller.has_signal("files_dropped_chunk"):
+		_native_controller.files_dropped_chunk.connect(_on_files_dropped_chunk)
+	if _native_controller.has_signal("files_dropped_resolved"):
+		_native_controller.files_dropped_resolved.connect(_on_files_dropped_resolved)
 	_native_controller.window_focus_changed.connect(_on_window_focus_changed)
 	_native_controller.window_moved.connect(_on_window_moved)
 	_native_controller.window_resized.connect(_on_window_resized)
 	_native_controller.monitor_changed.connect(_on_monitor_changed)
+	if _native_controller.has_signal("fit_completed"):
+		_native_controller.fit_completed.connect(_on_fit_completed)
+	if _native_controller.has_signal("window_attached"):
+		_native_controller.window_attached.connect(_on_native_window_attached)
+		_native_controller.attach_failed.connect(_on_native_attach_failed)
 	
 	print("All signals connected successfully")
 
 func _apply_settings():
 	if not _native_controller:
 		return
-		
 	
-	# 设置标志防止setter递归调用
-	_setting_properties = true
+	# 异步附加：结果通过window_attached/attach_failed返回后再应用设置
+	if async_attach and _native_controller.has_method("attach_window_async"):
+		_pending_attach_apply = true
+		if not _native_controller.attach_window_async():
+			_pending_attach_apply = false
+		return
 	
 	# 附加到当前窗口
-	var attach_result = _native_controller.attach_window()
+	_apply_attached_settings(_native_controller.attach_window())
+
+func _on_native_window_attached(attempt_count: int, frame_count: int):
+	_is_window_attached = true
+	if _pending_attach_apply:
+		_pending_attach_apply = false
+		var apply_begin_usec = Time.get_ticks_usec()
+		_apply_attached_settings(true)
+		_record_startup_phase("_apply_settings (attached)", apply_begin_usec, Time.get_ticks_usec())
+	if _finish_trace_on_attach:
+		_finish_trace_on_attach = false
+		_finish_startup_trace()
+	window_attached.emit(attempt_count, frame_count)
+
+func _on_native_attach_failed(attempt_count: int, frame_count: int):
+	if _pending_attach_apply:
+		_pending_attach_apply = false
+		_apply_attached_settings(false)
+	if _finish_trace_on_attach:
+		_finish_trace_on_attach = false
+		_finish_startup_trace()
+	attach_failed.emit(attempt_count, frame_count)
+
+func _apply_attached_settings(attach_result: bool):
+	# 设置标志防止setter递归调用
+	_setting_properties = true
 	
 	if attach_result:
 		_is_window_attached = true
@@ -338,6 +456,11 @@ func _apply_settings():
 		if force_windowed and DisplayServer.window_get_mode() == DisplayServer.WINDOW_MODE_FULLSCREEN:
 			DisplayServer.window_set_mode(DisplayServer.WINDOW_MODE_WINDOWED)
 		
+		# 批量应用窗口属性，commit时按依赖顺序一次性调用native
+		var batched = _native_controller.has_method("begin_update")
+		if batched:
+			_native_controller.begin_update()
+		
 		# 设置透明度
 		_configure_godot_transparency(is_transparent)
 		_native_controller.transparent = is_transparent
@@ -368,6 +491,9 @@ func _apply_settings():
 			_native_controller.allow_drop_files = allow_drop_files
 			print("Allow drop files initialized successfully")
 		
+		if batched:
+			_native_controller.commit()
+		
 		# 修复Bug2：应用监视器适配 - 复制Unity版本Start()中的关键逻辑
 		# 在窗口附加成功后立即执行监视器适配（Unity版本的UpdateMonitorFitting()逻辑）
 		# 优先级：use_all_monitors > should_fit_monitor > is_zoomed
@@ -385,7 +511,7 @@ func _apply_settings():
 			
 			if target_monitor_index >= 0:
 				_native_controller.fit_to_monitor(target_monitor_index)
-				print("应用启动时监视器适配完成: monitor " + str(target_monitor_index))
+				print("应用启动时开始监视器适配: monitor " + str(target_monitor_index))
 		
 		# hide_until_init_finished 功能：恢复窗口位置
 		if hide_until_init_finished:
@@ -620,6 +746,42 @@ func get_modifier_keys() -> int:
 		return _native_controller.get_modifier_keys()
 	return 0
 
+## 启动时间线：{finished, total_usec, phases: [{name, start_usec, duration_usec, thread}], marks: [{name, time_usec}]}
+## 时间为相对gdextension_init的微秒数
+func get_startup_timeline() -> Dictionary:
+	if _native_controller and _native_controller.has_method("get_startup_timeline"):
+		return _native_controller.get_startup_timeline()
+	return {}
+
+## 启动时间线的Chrome trace-event JSON，可保存后在chrome://tracing或Perfetto中打开
+func get_startup_trace_json() -> String:
+	if _native_controller and _native_controller.has_method("get_startup_trace_json"):
+		return _native_controller.get_startup_trace_json()
+	return ""
+
+## native库是否提供某项功能（UniWindowController.CAPABILITY_*，可按位组合）
+## 只检查请求的功能涉及的native函数，不会解析整个库
+func has_capability(capabilities: int) -> bool:
+	if _native_controller and _native_controller.has_method("has_capability"):
+		return _native_controller.has_capability(capabilities)
+	return false
+
+## 输入采样频率（Hz），0为每帧采样一次。光标、按键和修饰键的读取共用同一次采样
+func set_input_sample_rate(rate: int):
+	if _native_controller and _native_controller.has_method("set_input_sample_rate"):
+		_native_controller.set_input_sample_rate(rate)
+
+## 记录最近size次带时间戳的输入采样，0为不记录
+func set_input_history_size(size: int):
+	if _native_controller and _native_controller.has_method("set_input_history_size"):
+		_native_controller.set_input_history_size(size)
+
+## 输入采样历史：[time(秒), x, y, buttons, modifiers] * 采样数，从旧到新
+func get_input_history() -> PackedFloat64Array:
+	if _native_controller and _native_controller.has_method("get_input_history"):
+		return _native_controller.get_input_history()
+	return PackedFloat64Array()
+
 # Unity版本中的静态方法 - 监视器相关
 func get_monitor_count() -> int:
 	if _native_controller:
@@ -653,6 +815,12 @@ func attach_window() -> bool:
 	_is_window_attached = result
 	return result
 
+## 非阻塞附加，结果通过window_attached/attach_failed信号返回（不会重新应用导出的窗口设置）
+func attach_window_async() -> bool:
+	if not _native_controller or not _native_controller.has_method("attach_window_async"):
+		return false
+	return _native_controller.attach_window_async()
+
 func detach_window():
 	if _native_controller:
 		_native_controller.detach_window()
@@ -697,18 +865,31 @@ func get_current_monitor() -> int:
 		return _native_controller.get_current_monitor()
 	return 0
 
+## 像素回读统计：通过异步回读环避免的同步等待帧数
+func get_hit_test_stalls_avoided() -> int:
+	if _hit_tester:
+		return _hit_tester.get_stalls_avoided()
+	return 0
+
 ## 获取原生控制器引用（供其他脚本使用）
 func get_native_controller():  # 不指定返回类型，避免编译时依赖
 	return _native_controller
 
 ## 信号回调
 func _on_files_dropped(files: PackedStringArray):
-	print("*** GDScript received files_dropped signal ***")
-	print("Files count: ", files.size())
-	for i in range(files.size()):
-		print("  File ", i, ": ", files[i])
+	# 大量文件时逐个打印会阻塞帧，只输出数量
+	print("Files dropped: ", files.size())
 	files_dropped.emit(files)
 
+func _on_files_dropped_chunk(files: PackedStringArray, chunk_index: int, is_last: bool):
+	files_dropped_chunk.emit(files, chunk_index, is_last)
+
+func _on_files_dropped_resolved(entries: Array):
+	files_dropped_resolved.emit(entries)
+
+func _on_fit_completed(monitor_index: int, success: bool):
+	fit_completed.emit(monitor_index, success)
+
 func _on_window_focus_changed(focused: bool):
 	window_focus_changed.emit(focused)
 
@@ -832,7 +1013,10 @@ func _start_hit_test_coroutine():
 		return
 		
 	_is_checking_hit_test = true
-	_hit_test_texture = ImageTexture.new()
+	# 优先使用原生检测器，只回读光标附近的像素
+	if ClassDB.class_exists("UniWinHitTester"):
+		_hit_tester = ClassDB.instantiate("UniWinHitTester")
+		_hit_tester.readback_latency = hit_test_readback_latency
 	
 	# 启动检测协程
 	_hit_test_coroutine()
@@ -843,7 +1027,9 @@ func _hit_test_coroutine():
 	while _is_checking_hit_test and is_hit_test_enabled:
 		await get_tree().process_frame
 		
-		if hit_test_type == 1:  # HitTestType.Opacity
+		if _hit_tester and _native_controller and _is_window_attached:
+			_hit_test_by_native_tester()
+		elif hit_test_type == 1:  # HitTestType.Opacity
 			_hit_test_by_opaque_pixel()
 		elif hit_test_type == 2:  # HitTestType.Raycast  
 			_hit_test_by_raycast()
@@ -851,6 +1037,13 @@ func _hit_test_coroutine():
 			# ヒットテスト無しの場合は常にtrue
 			_internal_on_object = true
 
+func _hit_test_by_native_tester():
+	# 原生检测器一次完成像素检测和点击透传状态更新
+	if _hit_tester.update(get_viewport(), _native_controller):
+		is_click_through = _native_controller.click_through
+	_internal_on_object = _hit_tester.get_on_object()
+	_internal_picked_color = _hit_tester.get_picked_color()
+
 func _hit_test_by_opaque_pixel():
 	# 检测鼠标下是否有不透明像素，对应Unity版本的HitTestByOpaquePixel
 	var mouse_pos = _get_client_cursor_position()
@@ -911,34 +1104,21 @@ func _fit_to_all_monitors():
 		print("无法应用跨显示器设置：窗口未附加")
 		return
 		
+	# 原生实现按拓扑缓存计算，并一次设置位置和大小
+	if _native_controller.has_method("fit_to_all_monitors"):
+		if _native_controller.fit_to_all_monitors():
+			print("跨显示器窗口设置完成")
+		return
+	
 	var monitor_count = _native_controller.get_monitor_count()
 	if monitor_count <= 0:
 		print("无法获取显示器信息")
 		return
 		
-	print("开始计算跨所有显示器的窗口区域，显示器数量：", monitor_count)
-	
 	# 计算包含所有显示器的最小边界矩形
-	var min_x = 99999.0
-	var min_y = 99999.0
-	var max_x = -99999.0
-	var max_y = -99999.0
-	
-	for i in range(monitor_count):
-		var monitor_pos = _native_controller.get_monitor_position(i)
-		var monitor_size = _native_controller.get_monitor_size(i)
-		
-		print("显示器 ", i, " - 位置：", monitor_pos, " 大小：", monitor_size)
-		
-		# 更新边界
-		min_x = min(min_x, monitor_pos.x)
-		min_y = min(min_y, monitor_pos.y)
-		max_x = max(max_x, monitor_pos.x + monitor_size.x)
-		max_y = max(max_y, monitor_pos.y + monitor_size.y)
-	
-	# 计算包含所有显示器的窗口位置和大小
-	var all_monitors_pos = Vector2(min_x, min_y)
-	var all_monitors_size = Vector2(max_x - min_x, max_y - min_y)
+	var desktop_rect = _get_virtual_desktop_rect(_native_controller)
+	var all_monitors_pos = desktop_rect.position
+	var all_monitors_size = desktop_rect.size
 	
 	print("跨显示器窗口区域 - 位置：", all_monitors_pos, " 大小：", all_monitors_size)
 	
@@ -948,6 +1128,16 @@ func _fit_to_all_monitors():
 	
 	print("跨显示器窗口设置完成")
 
+## 所有显示器的外包矩形，原生控制器有拓扑缓存时一次调用取得
+func _get_virtual_desktop_rect(controller) -> Rect2:
+	if controller.has_method("get_virtual_desktop_rect"):
+		return controller.get_virtual_desktop_rect()
+	var desktop_rect = Rect2()
+	for i in range(controller.get_monitor_count()):
+		var monitor_rect = Rect2(controller.get_monitor_position(i), controller.get_monitor_size(i))
+		desktop_rect = monitor_rect if i == 0 else desktop_rect.merge(monitor_rect)
+	return desktop_rect
+
 func _hide_window_temporarily():
 	"""临时隐藏窗口到所有显示器区域外"""
 	if not _native_controller:
@@ -957,13 +1147,7 @@ func _hide_window_temporarily():
 	_target_position = _native_controller.position
 	
 	# 计算所有显示器的边界
-	var monitor_count = _native_controller.get_monitor_count()
-	var max_x = -99999.0
-	
-	for i in range(monitor_count):
-		var monitor_pos = _native_controller.get_monitor_position(i)
-		var monitor_size = _native_controller.get_monitor_size(i)
-		max_x = max(max_x, monitor_pos.x + monitor_size.x)
+	var max_x = _get_virtual_desktop_rect(_native_controller).end.x
 	
 	# 将窗口移动到所有显示器右侧外部区域
 	_hidden_position = Vector2(max_x + 1000, _target_position.y)
@@ -985,13 +1169,7 @@ func _hide_window_temporarily_early(temp_controller):
 		_target_position = Vector2(100, 100)  # 默认位置
 	
 	# 计算所有显示器的边界
-	var monitor_count = temp_controller.get_monitor_count()
-	var max_x = -99999.0
-	
-	for i in range(monitor_count):
-		var monitor_pos = temp_controller.get_monitor_position(i)
-		var monitor_size = temp_controller.get_monitor_size(i)
-		max_x = max(max_x, monitor_pos.x + monitor_size.x)
+	var max_x = _get_virtual_desktop_rect(temp_controller).end.x
 	
 	# 将窗口移动到所有显示器右侧外部区域
 	_hidden_position = Vector2(max_x + 1000, _target_position.y)
@@ -1019,6 +1197,7 @@ func _restore_window_position():
 func _exit_tree():
 	# 停止像素检测协程
 	_is_checking_hit_test = false
+	_hit_tester = null
 	
 	if not Engine.is_editor_hint() and _native_controller and auto_detach:
 		detach_window()
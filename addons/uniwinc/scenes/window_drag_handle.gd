@@ -12,6 +12,8 @@ class_name WindowDragHandle
 @export_group("Drag Settings")
 @export var disable_on_zoomed: bool = true ## 当窗口最大化时禁用拖拽
 @export var show_debug_info: bool = false ## 显示调试信息
+@export_range(0.0, 100.0, 0.5, "suffix:ms") var prediction_horizon: float = 0.0 ## 原生拖动时按光标速度预测的提前量，0为不预测
+@export_range(0.0, 500.0, 1.0, "suffix:px") var prediction_max_distance: float = 48.0 ## 预测位移上限，防止急停时过冲
 
 @export_group("Transparency Detection")
 @export var enable_transparency_detection: bool = true ## 启用透明度检测（与Unity一致）
@@ -22,6 +24,8 @@ var _mouse_offset: Vector2  # 鼠标相对于窗口的偏移量（在Native坐
 var _screen_height: int  # 主显示器高度，用于Y轴转换
 var _window_controller  # 不指定类型，避免编译时依赖
 var _is_hit_test_enabled: bool = true  # 记录拖拽前的hit test状态
+var _native_dragger  # 使用原生拖动引擎时的native控制器
+var _last_native_drag_position: Vector2  # 原生拖动时上一次通过dragging发出的位置
 
 ## 信号
 signal drag_started()
@@ -32,12 +36,28 @@ func _ready():
 	# 确保控件能接收鼠标事件
 	mouse_filter = Control.MOUSE_FILTER_STOP
 	
+	# 只在原生拖动期间逐帧发出dragging
+	set_process(false)
+	
 	# 在编辑器中不执行运行时逻辑
 	if Engine.is_editor_hint():
 		return
 	
 	_find_window_controller()
 
+## 原生拖动由native线程移动窗口，每帧把窗口的新位置通过dragging发出
+func _process(_delta):
+	if not _native_dragger:
+		set_process(false)
+		return
+	_emit_native_dragging()
+
+func _emit_native_dragging():
+	var window_position = _native_dragger.position
+	if window_position != _last_native_drag_position:
+		_last_native_drag_position = window_position
+		dragging.emit(window_position)
+
 ## 获取主控制器的透明检测结果
 func _get_on_opaque_pixel_from_controller() -> bool:
 	# 使用主控制器的透明检测结果，避免重复检测
@@ -152,6 +172,10 @@ func _start_drag(mouse_godot_position: Vector2):
 	if not _can_drag():
 		return
 	
+	# 优先使用原生拖动引擎：在独立线程跟随光标，不受帧率和GDScript开销影响
+	if _start_native_drag():
+		return
+	
 	# 获取屏幕高度用于坐标转换
 	var screen_rect = DisplayServer.screen_get_usable_rect()
 	_screen_height = screen_rect.size.y
@@ -177,6 +201,38 @@ func _start_drag(mouse_godot_position: Vector2):
 	_is_dragging = true
 	drag_started.emit()
 
+## 启动原生拖动，native控制器不支持时返回false
+func _start_native_drag() -> bool:
+	var native_controller = _window_controller.get_native_controller()
+	if not native_controller or not native_controller.has_method("start_window_drag"):
+		return false
+	
+	native_controller.drag_disable_on_zoomed = disable_on_zoomed
+	if "drag_prediction_horizon" in native_controller:
+		native_controller.drag_prediction_horizon = prediction_horizon
+		native_controller.drag_prediction_max_distance = prediction_max_distance
+	if not native_controller.window_drag_ended.is_connected(_on_native_drag_ended):
+		native_controller.window_drag_ended.connect(_on_native_drag_ended)
+	
+	if not _is_dragging:
+		_window_controller.set_click_through(false)
+	if not native_controller.start_window_drag():
+		return true  # 原生引擎拒绝（最大化、全屏等），与GDScript路径的结果一致
+	
+	_native_dragger = native_controller
+	_last_native_drag_position = native_controller.position
+	_is_dragging = true
+	set_process(true)
+	drag_started.emit()
+	return true
+
+func _on_native_drag_ended():
+	if _native_dragger:
+		_emit_native_dragging()
+		if show_debug_info and _native_dragger.has_method("get_drag_error_stats"):
+			print("拖拽偏差统计：", _native_dragger.get_drag_error_stats())
+	_end_drag()
+
 ## 获取Native窗口位置
 func _get_native_window_position() -> Vector2:
 	if _window_controller:
@@ -190,6 +246,10 @@ func _update_drag(mouse_godot_position: Vector2):
 	if not _window_controller or not _is_dragging:
 		return
 	
+	# 原生拖动由native线程移动窗口
+	if _native_dragger:
+		return
+	
 	# 检查各种拖拽条件
 	if not _can_drag():
 		_end_drag()
@@ -235,6 +295,11 @@ func _end_drag():
 	# 拖拽结束后，主控制器会根据当前鼠标位置自动设置点击透传状态
 	
 	_is_dragging = false
+	if _native_dragger:
+		var native_controller = _native_dragger
+		_native_dragger = null
+		set_process(false)
+		native_controller.stop_window_drag()
 	
 	# 发出信号
 	drag_ended.emit()
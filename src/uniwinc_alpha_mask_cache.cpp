@@ -0,0 +1,213 @@
+#include "uniwinc_alpha_mask_cache.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/atlas_texture.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#include <cstring>
+#include <iterator>
+
+using namespace godot;
+
+void AlphaMaskCache::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("is_opaque", "texture", "pixel", "threshold"), &AlphaMaskCache::is_opaque);
+    ClassDB::bind_method(D_METHOD("build_mask", "texture", "threshold"), &AlphaMaskCache::build_mask);
+    ClassDB::bind_method(D_METHOD("has_mask", "texture", "threshold"), &AlphaMaskCache::has_mask);
+    ClassDB::bind_method(D_METHOD("invalidate", "texture"), &AlphaMaskCache::invalidate);
+    ClassDB::bind_method(D_METHOD("clear"), &AlphaMaskCache::clear);
+    ClassDB::bind_method(D_METHOD("get_mask_count"), &AlphaMaskCache::get_mask_count);
+    ClassDB::bind_method(D_METHOD("get_memory_usage"), &AlphaMaskCache::get_memory_usage);
+
+    ClassDB::bind_method(D_METHOD("set_max_mask_count", "count"), &AlphaMaskCache::set_max_mask_count);
+    ClassDB::bind_method(D_METHOD("get_max_mask_count"), &AlphaMaskCache::get_max_mask_count);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_mask_count", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_max_mask_count", "get_max_mask_count");
+    ClassDB::bind_method(D_METHOD("set_max_memory_usage", "bytes"), &AlphaMaskCache::set_max_memory_usage);
+    ClassDB::bind_method(D_METHOD("get_max_memory_usage"), &AlphaMaskCache::get_max_memory_usage);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_memory_usage", PROPERTY_HINT_NONE, "suffix:B"), "set_max_memory_usage", "get_max_memory_usage");
+}
+
+AlphaMaskCache::AlphaMaskCache() {
+}
+
+AlphaMaskCache::~AlphaMaskCache() {
+    clear();
+}
+
+bool AlphaMaskCache::is_opaque(const Ref<Texture2D>& texture, const Vector2i& pixel, float threshold) {
+    const AlphaMask* mask = _get_or_build(texture, threshold);
+    if (!mask) {
+        return false;
+    }
+    if (pixel.x < 0 || pixel.x >= mask->width || pixel.y < 0 || pixel.y >= mask->height) {
+        return false;
+    }
+    uint64_t index = (uint64_t)pixel.y * mask->width + pixel.x;
+    return (mask->bits[index >> 6] >> (index & 63)) & 1;
+}
+
+bool AlphaMaskCache::build_mask(const Ref<Texture2D>& texture, float threshold) {
+    return _get_or_build(texture, threshold) != nullptr;
+}
+
+bool AlphaMaskCache::has_mask(const Ref<Texture2D>& texture, float threshold) const {
+    if (texture.is_null()) {
+        return false;
+    }
+    return _masks.find(_make_key(texture, threshold)) != _masks.end();
+}
+
+void AlphaMaskCache::invalidate(const Ref<Texture2D>& texture) {
+    if (texture.is_null()) {
+        return;
+    }
+    _on_texture_changed((int64_t)texture->get_instance_id());
+}
+
+void AlphaMaskCache::clear() {
+    while (!_masks.empty()) {
+        _erase(_masks.begin());
+    }
+}
+
+int AlphaMaskCache::get_mask_count() const {
+    return (int)_masks.size();
+}
+
+int64_t AlphaMaskCache::get_memory_usage() const {
+    return _memory_usage;
+}
+
+void AlphaMaskCache::set_max_mask_count(int count) {
+    _max_mask_count = MAX(count, 0);
+    _evict(nullptr);
+}
+
+int AlphaMaskCache::get_max_mask_count() const {
+    return _max_mask_count;
+}
+
+void AlphaMaskCache::set_max_memory_usage(int64_t bytes) {
+    _max_memory_usage = MAX(bytes, (int64_t)0);
+    _evict(nullptr);
+}
+
+int64_t AlphaMaskCache::get_max_memory_usage() const {
+    return _max_memory_usage;
+}
+
+AlphaMaskCache::MaskKey AlphaMaskCache::_make_key(const Ref<Texture2D>& texture, float threshold) {
+    MaskKey key;
+    // AtlasTexture的RID就是图集本身的RID，不同区域会冲突，改用实例ID区分
+    key.is_instance_id = Object::cast_to<AtlasTexture>(texture.ptr()) != nullptr;
+    key.texture_id = key.is_instance_id ? texture->get_instance_id() : texture->get_rid().get_id();
+    std::memcpy(&key.threshold_bits, &threshold, sizeof(uint32_t));
+    return key;
+}
+
+const AlphaMaskCache::AlphaMask* AlphaMaskCache::_get_or_build(const Ref<Texture2D>& texture, float threshold) {
+    if (texture.is_null()) {
+        return nullptr;
+    }
+
+    MaskKey key = _make_key(texture, threshold);
+    auto it = _masks.find(key);
+    if (it != _masks.end()) {
+        _lru.splice(_lru.begin(), _lru, it->second.lru);
+        return &it->second.mask;
+    }
+
+    // 只在首次查询时解码一次图像
+    Ref<Image> image = texture->get_image();
+    if (image.is_null() || image->is_empty()) {
+        return nullptr;
+    }
+    if (image->is_compressed()) {
+        image->decompress();
+    }
+    if (image->get_format() != Image::FORMAT_RGBA8) {
+        image->convert(Image::FORMAT_RGBA8);
+    }
+
+    AlphaMask mask;
+    mask.width = image->get_width();
+    mask.height = image->get_height();
+    uint64_t pixel_count = (uint64_t)mask.width * mask.height;
+    mask.bits.assign((pixel_count + 63) / 64, 0);
+
+    // 与GDScript版本一致：pixel_color.a > opacity_threshold
+    PackedByteArray data = image->get_data();
+    const uint8_t* bytes = data.ptr();
+    if ((uint64_t)data.size() < pixel_count * 4) {
+        return nullptr;
+    }
+    for (uint64_t i = 0; i < pixel_count; i++) {
+        if (bytes[i * 4 + 3] / 255.0f > threshold) {
+            mask.bits[i >> 6] |= (uint64_t)1 << (i & 63);
+        }
+    }
+
+    _retain_texture(texture);
+    _lru.push_front(key);
+    MaskEntry& entry = _masks[key];
+    entry.mask = std::move(mask);
+    entry.texture_instance_id = texture->get_instance_id();
+    entry.lru = _lru.begin();
+    _memory_usage += (int64_t)entry.mask.bits.size() * sizeof(uint64_t);
+
+    _evict(&key);
+    return &entry.mask;
+}
+
+void AlphaMaskCache::_erase(std::unordered_map<MaskKey, MaskEntry, MaskKeyHash>::iterator it) {
+    uint64_t texture_instance_id = it->second.texture_instance_id;
+    _memory_usage -= (int64_t)it->second.mask.bits.size() * sizeof(uint64_t);
+    _lru.erase(it->second.lru);
+    _masks.erase(it);
+    _release_texture(texture_instance_id);
+}
+
+void AlphaMaskCache::_evict(const MaskKey* keep) {
+    // 从最久未使用的开始淘汰，刚构建的位图即使单独超过上限也保留
+    while (!_lru.empty() &&
+           ((_max_mask_count > 0 && (int)_masks.size() > _max_mask_count) ||
+            (_max_memory_usage > 0 && _memory_usage > _max_memory_usage))) {
+        const MaskKey& oldest = _lru.back();
+        if (keep && oldest == *keep) {
+            break;
+        }
+        _erase(_masks.find(oldest));
+    }
+}
+
+void AlphaMaskCache::_retain_texture(const Ref<Texture2D>& texture) {
+    uint64_t texture_instance_id = texture->get_instance_id();
+    if (_texture_refs[texture_instance_id]++ == 0) {
+        // ImageTexture::update()等修改内容时RID不变，靠changed信号让位图失效
+        texture->connect("changed", callable_mp(this, &AlphaMaskCache::_on_texture_changed).bind((int64_t)texture_instance_id));
+    }
+}
+
+void AlphaMaskCache::_release_texture(uint64_t texture_instance_id) {
+    auto it = _texture_refs.find(texture_instance_id);
+    if (it == _texture_refs.end() || --it->second > 0) {
+        return;
+    }
+    _texture_refs.erase(it);
+    Object* texture = ObjectDB::get_instance(texture_instance_id);
+    Callable callback = callable_mp(this, &AlphaMaskCache::_on_texture_changed).bind((int64_t)texture_instance_id);
+    if (texture && texture->is_connected("changed", callback)) {
+        texture->disconnect("changed", callback);
+    }
+}
+
+void AlphaMaskCache::_on_texture_changed(int64_t texture_instance_id) {
+    for (auto it = _masks.begin(); it != _masks.end();) {
+        auto next = std::next(it);
+        if (it->second.texture_instance_id == (uint64_t)texture_instance_id) {
+            _erase(it);
+        }
+        it = next;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef UNIWINC_ALPHA_MASK_CACHE_H
+#define UNIWINC_ALPHA_MASK_CACHE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/texture2d.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+using namespace godot;
+
+// 纹理不透明度位图缓存 - 供ObjectDragHandle的精灵透明检测使用
+// 每个(纹理, 阈值)只解码一次图像，之后的点查询为O(1)的位测试
+// 纹理发出changed信号（如ImageTexture::update）时自动失效；超过数量或内存上限时淘汰最久未使用的位图
+class AlphaMaskCache : public RefCounted {
+    GDCLASS(AlphaMaskCache, RefCounted)
+
+private:
+    // 1像素1比特的不透明度位图
+    struct AlphaMask {
+        int width = 0;
+        int height = 0;
+        std::vector<uint64_t> bits;
+    };
+
+    // RID和实例ID是两套独立的编号，用is_instance_id区分，避免数值相同时冲突
+    struct MaskKey {
+        uint64_t texture_id;
+        uint32_t threshold_bits;
+        bool is_instance_id;
+
+        bool operator==(const MaskKey& other) const {
+            return texture_id == other.texture_id && threshold_bits == other.threshold_bits &&
+                   is_instance_id == other.is_instance_id;
+        }
+    };
+
+    struct MaskKeyHash {
+        size_t operator()(const MaskKey& key) const {
+            return (size_t)(key.texture_id * 0x9E3779B97F4A7C15ULL) ^ key.threshold_bits ^ (key.is_instance_id ? 0x80000000u : 0u);
+        }
+    };
+
+    struct MaskEntry {
+        AlphaMask mask;
+        uint64_t texture_instance_id = 0;   // 用于changed信号失效
+        std::list<MaskKey>::iterator lru;
+    };
+
+    std::unordered_map<MaskKey, MaskEntry, MaskKeyHash> _masks;
+    std::list<MaskKey> _lru;                            // 最近使用的在前
+    std::unordered_map<uint64_t, int> _texture_refs;    // 纹理实例ID -> 位图数量，用于连接/断开changed信号
+    int64_t _memory_usage = 0;
+    int _max_mask_count = 256;
+    int64_t _max_memory_usage = 64 * 1024 * 1024;
+
+protected:
+    static void _bind_methods();
+
+public:
+    AlphaMaskCache();
+    ~AlphaMaskCache();
+
+    // 查询纹理像素坐标处的不透明度（alpha > threshold），首次查询时构建位图
+    bool is_opaque(const Ref<Texture2D>& texture, const Vector2i& pixel, float threshold);
+
+    // 预先构建位图（例如在场景加载时对所有动画帧调用）
+    bool build_mask(const Ref<Texture2D>& texture, float threshold);
+    bool has_mask(const Ref<Texture2D>& texture, float threshold) const;
+
+    // 发出changed信号的纹理会自动失效，其他方式修改内容时手动失效
+    void invalidate(const Ref<Texture2D>& texture);
+    void clear();
+
+    int get_mask_count() const;
+    int64_t get_memory_usage() const;
+
+    // 缓存上限，0为不限制；超过时淘汰最久未使用的位图
+    void set_max_mask_count(int count);
+    int get_max_mask_count() const;
+    void set_max_memory_usage(int64_t bytes);
+    int64_t get_max_memory_usage() const;
+
+private:
+    static MaskKey _make_key(const Ref<Texture2D>& texture, float threshold);
+    const AlphaMask* _get_or_build(const Ref<Texture2D>& texture, float threshold);
+    void _erase(std::unordered_map<MaskKey, MaskEntry, MaskKeyHash>::iterator it);
+    void _evict(const MaskKey* keep);
+    void _retain_texture(const Ref<Texture2D>& texture);
+    void _release_texture(uint64_t texture_instance_id);
+    void _on_texture_changed(int64_t texture_instance_id);
+};
+
+#endif // UNIWINC_ALPHA_MASK_CACHE_H
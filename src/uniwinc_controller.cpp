@@ -1,23 +1,91 @@
 #include "uniwinc_controller.h"
 #include "uniwinc_core.h"
+#include "uniwinc_log.h"
+#include "uniwinc_mpsc_queue.h"
+#include "uniwinc_path_list.h"
+#include "uniwinc_startup_trace.h"
 
 #include <godot_cpp/core/class_db.hpp>
-#include <godot_cpp/variant/utility_functions.hpp>
 
-#ifdef _WIN32
-    #include <windows.h>
-    #include <vector>
-#endif
+#include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/window.hpp>
+#include <godot_cpp/core/object.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#include <unordered_map>
+#include <vector>
 
 using namespace godot;
 
-// 静态实例用于回调
-static UniWindowController* g_controller_instance = nullptr;
+// 窗口句柄 -> 控制器（只在主线程访问）
+static std::unordered_map<int64_t, UniWindowController*> g_controllers;
+// 当前附加到native库的窗口句柄，回调线程据此给事件打标记
+static std::atomic<int64_t> g_attached_window_key(0);
+// 已初始化native库的控制器数量，最后一个清理时才卸载库
+static int g_initialized_controllers = 0;
+
+// native回调 -> 主线程的事件队列
+static UniWinMpscQueue<UniWindowController::NativeEvent, 256> g_native_events;
+static std::atomic<uint64_t> g_dropped_native_events(0);
 
 void UniWindowController::_bind_methods() {
     // 绑定方法
     ClassDB::bind_method(D_METHOD("attach_window"), &UniWindowController::attach_window);
     ClassDB::bind_method(D_METHOD("detach_window"), &UniWindowController::detach_window);
+    ClassDB::bind_method(D_METHOD("attach_window_async"), &UniWindowController::attach_window_async);
+    ClassDB::bind_method(D_METHOD("cancel_attach"), &UniWindowController::cancel_attach);
+    ClassDB::bind_method(D_METHOD("is_attach_pending"), &UniWindowController::is_attach_pending);
+    ClassDB::bind_method(D_METHOD("get_attach_frame_count"), &UniWindowController::get_attach_frame_count);
+    ClassDB::bind_method(D_METHOD("get_attach_attempt_count"), &UniWindowController::get_attach_attempt_count);
+    ClassDB::bind_method(D_METHOD("set_attach_retry_delay", "seconds"), &UniWindowController::set_attach_retry_delay);
+    ClassDB::bind_method(D_METHOD("get_attach_retry_delay"), &UniWindowController::get_attach_retry_delay);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "attach_retry_delay", PROPERTY_HINT_RANGE, "0,1,0.001,suffix:s"), "set_attach_retry_delay", "get_attach_retry_delay");
+    ClassDB::bind_method(D_METHOD("set_attach_max_retry_delay", "seconds"), &UniWindowController::set_attach_max_retry_delay);
+    ClassDB::bind_method(D_METHOD("get_attach_max_retry_delay"), &UniWindowController::get_attach_max_retry_delay);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "attach_max_retry_delay", PROPERTY_HINT_RANGE, "0,5,0.01,suffix:s"), "set_attach_max_retry_delay", "get_attach_max_retry_delay");
+    ClassDB::bind_method(D_METHOD("set_attach_timeout", "seconds"), &UniWindowController::set_attach_timeout);
+    ClassDB::bind_method(D_METHOD("get_attach_timeout"), &UniWindowController::get_attach_timeout);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "attach_timeout", PROPERTY_HINT_RANGE, "0,30,0.1,suffix:s"), "set_attach_timeout", "get_attach_timeout");
+    ClassDB::bind_method(D_METHOD("begin_update"), &UniWindowController::begin_update);
+    ClassDB::bind_method(D_METHOD("commit"), &UniWindowController::commit);
+    ClassDB::bind_method(D_METHOD("is_updating"), &UniWindowController::is_updating);
+    
+    // 异步窗口命令
+    ClassDB::bind_method(D_METHOD("set_async_window_commands", "enabled"), &UniWindowController::set_async_window_commands);
+    ClassDB::bind_method(D_METHOD("get_async_window_commands"), &UniWindowController::get_async_window_commands);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "async_window_commands"), "set_async_window_commands", "get_async_window_commands");
+    ClassDB::bind_integer_constant(get_class_static(), "WindowCommand", "WINDOW_COMMAND_SET_SIZE", WINDOW_COMMAND_SET_SIZE);
+    ClassDB::bind_integer_constant(get_class_static(), "WindowCommand", "WINDOW_COMMAND_SET_POSITION", WINDOW_COMMAND_SET_POSITION);
+    ClassDB::bind_integer_constant(get_class_static(), "WindowCommand", "WINDOW_COMMAND_SET_RECT", WINDOW_COMMAND_SET_RECT);
+    ClassDB::bind_integer_constant(get_class_static(), "WindowCommand", "WINDOW_COMMAND_SET_ZOOMED", WINDOW_COMMAND_SET_ZOOMED);
+    ClassDB::bind_integer_constant(get_class_static(), "WindowCommand", "WINDOW_COMMAND_FIT_TO_MONITOR", WINDOW_COMMAND_FIT_TO_MONITOR);
+    
+    // native库功能位（按需解析符号）
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("get_capabilities"), &UniWindowController::get_capabilities);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("has_capability", "capabilities"), &UniWindowController::has_capability);
+    
+    // 启动时间线
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("add_startup_phase", "name", "start_ticks_usec", "end_ticks_usec"), &UniWindowController::add_startup_phase);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("finish_startup_trace"), &UniWindowController::finish_startup_trace);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("get_startup_timeline"), &UniWindowController::get_startup_timeline);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("get_startup_trace_json"), &UniWindowController::get_startup_trace_json);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_WINDOW_ATTACH", CAPABILITY_WINDOW_ATTACH, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_TRANSPARENCY", CAPABILITY_TRANSPARENCY, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_WINDOW_STYLE", CAPABILITY_WINDOW_STYLE, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_CLICK_THROUGH", CAPABILITY_CLICK_THROUGH, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_WINDOW_RECT", CAPABILITY_WINDOW_RECT, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_MAXIMIZE", CAPABILITY_MAXIMIZE, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_MONITORS", CAPABILITY_MONITORS, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_FIT_TO_MONITOR", CAPABILITY_FIT_TO_MONITOR, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_CURSOR", CAPABILITY_CURSOR, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_MOUSE_KEYBOARD", CAPABILITY_MOUSE_KEYBOARD, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_DROP_FILES", CAPABILITY_DROP_FILES, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_FILE_DIALOGS", CAPABILITY_FILE_DIALOGS, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_WINDOW_EVENTS", CAPABILITY_WINDOW_EVENTS, true);
+    ClassDB::bind_integer_constant(get_class_static(), "Capability", "CAPABILITY_KEY_COLOR", CAPABILITY_KEY_COLOR, true);
     
     // 基础属性绑定
     ClassDB::bind_method(D_METHOD("set_transparent", "transparent"), &UniWindowController::set_transparent);
@@ -95,15 +163,73 @@ void UniWindowController::_bind_methods() {
     ClassDB::bind_method(D_METHOD("is_active"), &UniWindowController::is_active);
     ClassDB::bind_method(D_METHOD("is_maximized"), &UniWindowController::is_maximized);
     ClassDB::bind_method(D_METHOD("is_minimized"), &UniWindowController::is_minimized);
+    ClassDB::bind_method(D_METHOD("get_window_handle"), &UniWindowController::get_window_handle);
+    ClassDB::bind_method(D_METHOD("get_dropped_native_event_count"), &UniWindowController::get_dropped_native_event_count);
+    
+    // 移动/缩放事件合并
+    ClassDB::bind_method(D_METHOD("set_coalesce_window_events", "enabled"), &UniWindowController::set_coalesce_window_events);
+    ClassDB::bind_method(D_METHOD("get_coalesce_window_events"), &UniWindowController::get_coalesce_window_events);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "coalesce_window_events"), "set_coalesce_window_events", "get_coalesce_window_events");
+    ClassDB::bind_method(D_METHOD("get_window_moved_event_count"), &UniWindowController::get_window_moved_event_count);
+    
+    // 大批量拖放分块
+    ClassDB::bind_method(D_METHOD("set_drop_chunk_size", "size"), &UniWindowController::set_drop_chunk_size);
+    ClassDB::bind_method(D_METHOD("get_drop_chunk_size"), &UniWindowController::get_drop_chunk_size);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "drop_chunk_size", PROPERTY_HINT_RANGE, "0,100000,1,or_greater"), "set_drop_chunk_size", "get_drop_chunk_size");
+    
+    // 拖放文件后台解析
+    ClassDB::bind_method(D_METHOD("set_resolve_dropped_files", "enabled"), &UniWindowController::set_resolve_dropped_files);
+    ClassDB::bind_method(D_METHOD("get_resolve_dropped_files"), &UniWindowController::get_resolve_dropped_files);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "resolve_dropped_files"), "set_resolve_dropped_files", "get_resolve_dropped_files");
+    ClassDB::bind_method(D_METHOD("set_drop_resolve_depth", "depth"), &UniWindowController::set_drop_resolve_depth);
+    ClassDB::bind_method(D_METHOD("get_drop_resolve_depth"), &UniWindowController::get_drop_resolve_depth);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "drop_resolve_depth", PROPERTY_HINT_RANGE, "0,32"), "set_drop_resolve_depth", "get_drop_resolve_depth");
+    ClassDB::bind_method(D_METHOD("set_drop_resolve_max_entries", "max_entries"), &UniWindowController::set_drop_resolve_max_entries);
+    ClassDB::bind_method(D_METHOD("get_drop_resolve_max_entries"), &UniWindowController::get_drop_resolve_max_entries);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "drop_resolve_max_entries", PROPERTY_HINT_RANGE, "0,1000000,1,or_greater"), "set_drop_resolve_max_entries", "get_drop_resolve_max_entries");
+    ClassDB::bind_method(D_METHOD("set_drop_resolve_filters", "filters"), &UniWindowController::set_drop_resolve_filters);
+    ClassDB::bind_method(D_METHOD("get_drop_resolve_filters"), &UniWindowController::get_drop_resolve_filters);
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_STRING_ARRAY, "drop_resolve_filters"), "set_drop_resolve_filters", "get_drop_resolve_filters");
+
+    ClassDB::bind_method(D_METHOD("set_drag_poll_rate", "rate"), &UniWindowController::set_drag_poll_rate);
+    ClassDB::bind_method(D_METHOD("get_drag_poll_rate"), &UniWindowController::get_drag_poll_rate);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "drag_poll_rate", PROPERTY_HINT_RANGE, "30,1000,1,suffix:Hz"), "set_drag_poll_rate", "get_drag_poll_rate");
+    ClassDB::bind_method(D_METHOD("set_drag_disable_on_zoomed", "disable"), &UniWindowController::set_drag_disable_on_zoomed);
+    ClassDB::bind_method(D_METHOD("get_drag_disable_on_zoomed"), &UniWindowController::get_drag_disable_on_zoomed);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "drag_disable_on_zoomed"), "set_drag_disable_on_zoomed", "get_drag_disable_on_zoomed");
+    ClassDB::bind_method(D_METHOD("set_drag_prediction_horizon", "milliseconds"), &UniWindowController::set_drag_prediction_horizon);
+    ClassDB::bind_method(D_METHOD("get_drag_prediction_horizon"), &UniWindowController::get_drag_prediction_horizon);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "drag_prediction_horizon", PROPERTY_HINT_RANGE, "0,100,0.5,suffix:ms"), "set_drag_prediction_horizon", "get_drag_prediction_horizon");
+    ClassDB::bind_method(D_METHOD("set_drag_prediction_max_distance", "distance"), &UniWindowController::set_drag_prediction_max_distance);
+    ClassDB::bind_method(D_METHOD("get_drag_prediction_max_distance"), &UniWindowController::get_drag_prediction_max_distance);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "drag_prediction_max_distance", PROPERTY_HINT_RANGE, "0,500,1,suffix:px"), "set_drag_prediction_max_distance", "get_drag_prediction_max_distance");
+    ClassDB::bind_method(D_METHOD("set_drag_prediction_use_acceleration", "enabled"), &UniWindowController::set_drag_prediction_use_acceleration);
+    ClassDB::bind_method(D_METHOD("get_drag_prediction_use_acceleration"), &UniWindowController::get_drag_prediction_use_acceleration);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "drag_prediction_use_acceleration"), "set_drag_prediction_use_acceleration", "get_drag_prediction_use_acceleration");
+    ClassDB::bind_method(D_METHOD("get_drag_error_stats"), &UniWindowController::get_drag_error_stats);
+    ClassDB::bind_method(D_METHOD("start_window_drag"), &UniWindowController::start_window_drag);
+    ClassDB::bind_method(D_METHOD("stop_window_drag"), &UniWindowController::stop_window_drag);
+    ClassDB::bind_method(D_METHOD("is_window_dragging"), &UniWindowController::is_window_dragging);
+    ClassDB::bind_method(D_METHOD("get_window_resized_event_count"), &UniWindowController::get_window_resized_event_count);
     
     // 多显示器方法
     ClassDB::bind_method(D_METHOD("get_monitor_count"), &UniWindowController::get_monitor_count);
     ClassDB::bind_method(D_METHOD("get_monitor_size", "monitor_index"), &UniWindowController::get_monitor_size);
     ClassDB::bind_method(D_METHOD("get_monitor_position", "monitor_index"), &UniWindowController::get_monitor_position);
     ClassDB::bind_method(D_METHOD("get_current_monitor"), &UniWindowController::get_current_monitor);
+    ClassDB::bind_method(D_METHOD("get_monitor_rects"), &UniWindowController::get_monitor_rects);
+    ClassDB::bind_method(D_METHOD("get_virtual_desktop_rect"), &UniWindowController::get_virtual_desktop_rect);
+    ClassDB::bind_method(D_METHOD("get_monitor_dpi", "monitor_index"), &UniWindowController::get_monitor_dpi);
     
     // 修复Bug2：添加fit_to_monitor方法绑定
     ClassDB::bind_method(D_METHOD("fit_to_monitor", "monitor_index"), &UniWindowController::fit_to_monitor);
+    ClassDB::bind_method(D_METHOD("set_fit_timeout", "seconds"), &UniWindowController::set_fit_timeout);
+    ClassDB::bind_method(D_METHOD("get_fit_timeout"), &UniWindowController::get_fit_timeout);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "fit_timeout", PROPERTY_HINT_RANGE, "0,5,0.05,suffix:s"), "set_fit_timeout", "get_fit_timeout");
+    ClassDB::bind_method(D_METHOD("is_fitting"), &UniWindowController::is_fitting);
+    ClassDB::bind_method(D_METHOD("fit_to_all_monitors"), &UniWindowController::fit_to_all_monitors);
+    ClassDB::bind_method(D_METHOD("fit_to_monitor_set", "monitor_indices"), &UniWindowController::fit_to_monitor_set);
+    ClassDB::bind_method(D_METHOD("set_window_rect", "rect"), &UniWindowController::set_window_rect);
     
     // 窗口控制方法
     ClassDB::bind_method(D_METHOD("set_window_title", "title"), &UniWindowController::set_window_title);
@@ -119,28 +245,43 @@ void UniWindowController::_bind_methods() {
     ClassDB::bind_static_method("UniWindowController", D_METHOD("set_cursor_position", "position"), &UniWindowController::set_cursor_position);
     ClassDB::bind_static_method("UniWindowController", D_METHOD("get_mouse_buttons"), &UniWindowController::get_mouse_buttons);
     ClassDB::bind_static_method("UniWindowController", D_METHOD("get_modifier_keys"), &UniWindowController::get_modifier_keys);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("set_input_sample_rate", "rate"), &UniWindowController::set_input_sample_rate);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("get_input_sample_rate"), &UniWindowController::get_input_sample_rate);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("set_input_history_size", "size"), &UniWindowController::set_input_history_size);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("get_input_history_size"), &UniWindowController::get_input_history_size);
+    ClassDB::bind_static_method("UniWindowController", D_METHOD("get_input_history"), &UniWindowController::get_input_history);
     
     // 信号定义
     ADD_SIGNAL(MethodInfo("files_dropped", PropertyInfo(Variant::PACKED_STRING_ARRAY, "files")));
+    ADD_SIGNAL(MethodInfo("files_dropped_resolved", PropertyInfo(Variant::ARRAY, "entries")));
+    ADD_SIGNAL(MethodInfo("files_dropped_chunk", PropertyInfo(Variant::PACKED_STRING_ARRAY, "files"), PropertyInfo(Variant::INT, "chunk_index"), PropertyInfo(Variant::BOOL, "is_last")));
     ADD_SIGNAL(MethodInfo("window_focus_changed", PropertyInfo(Variant::BOOL, "focused")));
     ADD_SIGNAL(MethodInfo("window_moved", PropertyInfo(Variant::VECTOR2, "position")));
     ADD_SIGNAL(MethodInfo("window_resized", PropertyInfo(Variant::VECTOR2, "size")));
     ADD_SIGNAL(MethodInfo("monitor_changed", PropertyInfo(Variant::INT, "monitor_index")));
+    ADD_SIGNAL(MethodInfo("window_command_completed", PropertyInfo(Variant::INT, "command")));
+    ADD_SIGNAL(MethodInfo("window_drag_started"));
+    ADD_SIGNAL(MethodInfo("window_drag_ended"));
+    ADD_SIGNAL(MethodInfo("fit_completed", PropertyInfo(Variant::INT, "monitor_index"), PropertyInfo(Variant::BOOL, "success")));
+    ADD_SIGNAL(MethodInfo("window_attached", PropertyInfo(Variant::INT, "attempt_count"), PropertyInfo(Variant::INT, "frame_count")));
+    ADD_SIGNAL(MethodInfo("attach_failed", PropertyInfo(Variant::INT, "attempt_count"), PropertyInfo(Variant::INT, "frame_count")));
 }
 
 UniWindowController::UniWindowController() {
-    g_controller_instance = this;
 }
 
 UniWindowController::~UniWindowController() {
-    if (g_controller_instance == this) {
-        g_controller_instance = nullptr;
-    }
+    _window_dragger.reset();  // 拖动线程会调用native，必须在卸载库之前停止
+    _unregister_window();
     _cleanup_native();
+    if (g_controllers.empty()) {
+        _discard_native_events();
+    }
 }
 
 void UniWindowController::_ready() {
-    UtilityFunctions::print("UniWindowController ready");
+    UNIWINC_TRACE_SCOPE("UniWindowController::_ready");
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "UniWindowController ready");
     _initialize_native();
 }
 
@@ -149,47 +290,402 @@ void UniWindowController::_process(double delta) {
         return;
     }
     
+    // 异步附加的退避重试
+    _process_attach(delta);
+    
     // 定期更新状态
     _update_from_native();
+    
+    // 记录历史时即使本帧没有读取者也要采样，保证历史连续
+    if (UniWinCore::get_input_history_size() > 0) {
+        UniWinCore::get_input_sample();
+    }
+    
+    // 分发native回调事件（所有控制器共用一个队列，先处理的控制器负责分发全部事件）
+    _dispatch_native_events();
+    
+    // 大批量拖放每帧解析一块
+    _process_pending_drops();
+    
+    // 取回后台解析完成的拖放元数据
+    if (_drop_resolver) {
+        Array entries;
+        while (_drop_resolver->poll(&entries)) {
+            emit_signal("files_dropped_resolved", entries);
+            entries = Array();
+        }
+    }
+    
+    // 原生拖动：应用主线程移动的目标位置，转发线程结束的通知
+    _process_window_drag();
+    
+    // 推进fit_to_monitor状态机
+    _process_fit(delta);
+    
+    // 提交本帧合并后的异步窗口命令，并分发已完成的命令
+    if (UniWinCore::get_async_commands()) {
+        UniWinCore::flush_commands();
+    }
+    WindowCommand completed;
+    while (UniWinCore::pop_completed_command(&completed)) {
+        UniWindowController* target = _find_controller(g_attached_window_key.load(std::memory_order_acquire));
+        target = target ? target : this;
+        target->emit_signal("window_command_completed", completed.type);
+        if (completed.type == WINDOW_COMMAND_FIT_TO_MONITOR) {
+            target->emit_signal("fit_completed", completed.value, true);
+        }
+    }
+}
+
+int64_t UniWindowController::get_window_handle() const {
+    int window_id = DisplayServer::MAIN_WINDOW_ID;
+    if (is_inside_tree() && get_window()) {
+        window_id = get_window()->get_window_id();
+    }
+    return DisplayServer::get_singleton()->window_get_native_handle(DisplayServer::WINDOW_HANDLE, window_id);
+}
+
+UniWindowController* UniWindowController::_find_controller(int64_t window_key) {
+    auto it = g_controllers.find(window_key);
+    return it != g_controllers.end() ? it->second : nullptr;
+}
+
+bool UniWindowController::_is_in_main_window() const {
+    if (!is_inside_tree() || !get_window()) {
+        return true;
+    }
+    // 嵌入的子窗口没有自己的native窗口（INVALID_WINDOW_ID），实际显示在主窗口中
+    int window_id = get_window()->get_window_id();
+    return window_id == DisplayServer::MAIN_WINDOW_ID || window_id == DisplayServer::INVALID_WINDOW_ID;
+}
+
+void UniWindowController::_register_window() {
+    _unregister_window();
+    // native库附加的是进程自己的主窗口，而不是控制器所在的窗口，键和句柄都取主窗口的
+    _window_key = DisplayServer::get_singleton()->window_get_native_handle(DisplayServer::WINDOW_HANDLE, DisplayServer::MAIN_WINDOW_ID);
+    if (_window_key == 0) {
+        _window_key = -1;  // 无法取得native句柄（如headless）时使用占位键
+    }
+    
+    UniWindowController*& slot = g_controllers[_window_key];
+    if (slot && slot != this) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_WINDOW, "Another UniWindowController was attached to the same window, replacing it");
+        slot->_release_native_window();
+        slot->_window_key = 0;
+    }
+    slot = this;
+    // native库同一时间只附加一个窗口，之后的回调都属于这个窗口；
+    // 之前附加其他窗口的控制器不再驱动native，变为非活动状态
+    UniWindowController* previous = _find_controller(g_attached_window_key.load(std::memory_order_acquire));
+    if (previous && previous != this) {
+        previous->_release_native_window();
+    }
+    g_attached_window_key.store(_window_key, std::memory_order_release);
+    UniWinCore::set_native_window_handle(_window_key > 0 ? _window_key : 0);
+}
+
+void UniWindowController::_unregister_window() {
+    if (_window_key == 0) {
+        return;
+    }
+    auto it = g_controllers.find(_window_key);
+    if (it != g_controllers.end() && it->second == this) {
+        g_controllers.erase(it);
+    }
+    int64_t expected = _window_key;
+    if (g_attached_window_key.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+        UniWinCore::set_native_window_handle(0);
+    }
+    _window_key = 0;
+}
+
+bool UniWindowController::_owns_native_window() const {
+    return _window_key != 0 && g_attached_window_key.load(std::memory_order_acquire) == _window_key;
+}
+
+void UniWindowController::_release_native_window() {
+    // native窗口已被其他控制器接管：只清理本地状态，不调用native分离
+    if (!_is_active) {
+        return;
+    }
+    stop_window_drag();
+    _is_active = false;
+    if (_fit_state != FIT_IDLE) {
+        _finish_fit(false);
+    }
 }
 
 bool UniWindowController::attach_window() {
+    UNIWINC_TRACE_SCOPE("UniWindowController::attach_window");
+    if (!_is_in_main_window()) {
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_WINDOW, "Cannot attach from a separate Window: the native library can only drive the main window");
+        return false;
+    }
     if (!_is_initialized) {
         _initialize_native();
     }
     
     // 多次尝试附加，因为Godot窗口可能需要时间初始化
     for (int attempt = 0; attempt < 3; attempt++) {
-        _is_active = UniWinCore::attach_window();
-        if (_is_active) {
-            UtilityFunctions::print("Window attached successfully on attempt " + String::num_int64(attempt + 1));
+        if (_try_attach()) {
+            UNIWINC_LOG_INFO(UniWinLog::CATEGORY_WINDOW, "Window attached successfully on attempt " + String::num_int64(attempt + 1));
             return true;
         }
         
-        // 等待一小段时间后重试
+        // 连续重试，需要在帧之间等待时使用attach_window_async
         if (attempt < 2) {
-            UtilityFunctions::print("Attach attempt " + String::num_int64(attempt + 1) + " failed, retrying...");
-            // 在实际应用中，这里可能需要使用定时器而不是阻塞
+            UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_WINDOW, "Attach attempt " + String::num_int64(attempt + 1) + " failed, retrying...");
         }
     }
     
-    UtilityFunctions::print("Failed to attach window after 3 attempts");
+    UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_WINDOW, "Failed to attach window after 3 attempts");
     return false;
 }
 
+bool UniWindowController::_try_attach(bool quiet) {
+    _is_active = UniWinCore::attach_window(quiet);
+    if (_is_active) {
+        _register_window();
+    }
+    return _is_active;
+}
+
+bool UniWindowController::attach_window_async() {
+    if (_attach_pending) {
+        return false;
+    }
+    if (!_is_initialized) {
+        _initialize_native();
+    }
+    
+    _attach_pending = true;
+    _attach_attempts = 0;
+    _attach_start_frame = Engine::get_singleton()->get_process_frames();
+    _attach_elapsed = 0.0;
+    _attach_next_attempt = 0.0;
+    _attach_delay = _attach_retry_delay;
+    _attach_frame_count = -1;
+    
+    // 库加载失败或不在主窗口中时重试没有意义
+    if (!_is_in_main_window()) {
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_WINDOW, "Cannot attach from a separate Window: the native library can only drive the main window");
+        _finish_attach(false);
+        return true;
+    }
+    if (!_is_initialized) {
+        _finish_attach(false);
+        return true;
+    }
+    // 第一次尝试立即进行，窗口已就绪时与attach_window一样在本帧完成
+    _process_attach(0.0);
+    return true;
+}
+
+void UniWindowController::cancel_attach() {
+    _attach_pending = false;
+}
+
+bool UniWindowController::is_attach_pending() const {
+    return _attach_pending;
+}
+
+int UniWindowController::get_attach_frame_count() const {
+    return _attach_frame_count;
+}
+
+int UniWindowController::get_attach_attempt_count() const {
+    return _attach_attempts;
+}
+
+void UniWindowController::set_attach_retry_delay(double seconds) {
+    _attach_retry_delay = MAX(seconds, 0.0);
+}
+
+double UniWindowController::get_attach_retry_delay() const {
+    return _attach_retry_delay;
+}
+
+void UniWindowController::set_attach_max_retry_delay(double seconds) {
+    _attach_max_retry_delay = MAX(seconds, 0.0);
+}
+
+double UniWindowController::get_attach_max_retry_delay() const {
+    return _attach_max_retry_delay;
+}
+
+void UniWindowController::set_attach_timeout(double seconds) {
+    _attach_timeout = MAX(seconds, 0.0);
+}
+
+double UniWindowController::get_attach_timeout() const {
+    return _attach_timeout;
+}
+
+void UniWindowController::_process_attach(double delta) {
+    if (!_attach_pending) {
+        return;
+    }
+    _attach_elapsed += delta;
+    if (_attach_elapsed < _attach_next_attempt) {
+        return;
+    }
+    
+    _attach_attempts++;
+    // 每次失败只记录DEBUG日志，attach_failed发出时报告一次错误
+    if (_try_attach(true)) {
+        UNIWINC_LOG_INFO(UniWinLog::CATEGORY_WINDOW, "Window attached asynchronously on attempt " + String::num_int64(_attach_attempts));
+        _finish_attach(true);
+        return;
+    }
+    
+    // 每次失败间隔加倍，下一次尝试超过期限时放弃
+    double next_attempt = _attach_elapsed + _attach_delay;
+    if (next_attempt > _attach_timeout) {
+        _finish_attach(false);
+        return;
+    }
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "Attach attempt " + String::num_int64(_attach_attempts) + " failed, retrying in " + String::num(_attach_delay, 3) + "s");
+    _attach_next_attempt = next_attempt;
+    _attach_delay = MIN(_attach_delay * 2.0, _attach_max_retry_delay);
+}
+
+void UniWindowController::_finish_attach(bool success) {
+    _attach_pending = false;
+    _attach_frame_count = (int)(Engine::get_singleton()->get_process_frames() - _attach_start_frame);
+    if (!success) {
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_WINDOW, "Failed to attach window after " + String::num_int64(_attach_attempts) + " attempts");
+    }
+    emit_signal(success ? "window_attached" : "attach_failed", _attach_attempts, _attach_frame_count);
+}
+
 void UniWindowController::detach_window() {
+    cancel_attach();
     if (_is_active) {
-        UniWinCore::detach_window();
+        stop_window_drag();
+        // 只有当前附加native库的控制器才执行native分离，否则会把其他控制器的窗口分离掉
+        if (_owns_native_window()) {
+            UniWinCore::detach_window();
+        }
         _is_active = false;
-        UtilityFunctions::print("Window detached");
+        if (_fit_state != FIT_IDLE) {
+            _finish_fit(false);
+        }
+        _unregister_window();
+        UNIWINC_LOG_INFO(UniWinLog::CATEGORY_WINDOW, "Window detached");
+    }
+}
+
+void UniWindowController::begin_update() {
+    _update_depth++;
+}
+
+void UniWindowController::commit() {
+    if (_update_depth <= 0) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_WINDOW, "commit() called without matching begin_update()");
+        return;
+    }
+    if (--_update_depth > 0) {
+        return;
+    }
+    
+    uint32_t flags = _dirty_mask;
+    _dirty_mask = 0;
+    _apply_dirty(flags);
+}
+
+bool UniWindowController::is_updating() const {
+    return _update_depth > 0;
+}
+
+void UniWindowController::set_async_window_commands(bool enabled) {
+    _async_window_commands = enabled;
+    if (_is_initialized) {
+        UniWinCore::set_async_commands(enabled);
+    }
+}
+
+bool UniWindowController::get_async_window_commands() const {
+    return _async_window_commands;
+}
+
+void UniWindowController::_mark_dirty(uint32_t flags) {
+    if (_update_depth > 0) {
+        _dirty_mask |= flags;
+        return;
+    }
+    _apply_dirty(flags);
+}
+
+// 按依赖顺序应用属性，每个属性最多调用一次native
+void UniWindowController::_apply_dirty(uint32_t flags) {
+    if (!_is_active || flags == 0) {
+        return;
+    }
+    
+    // 透明方式和键色决定set_transparent的效果，必须先设置
+    if (flags & DIRTY_TRANSPARENT_TYPE) {
+        UniWinCore::set_transparent_type(_transparent_type);
+    }
+    if (flags & DIRTY_KEY_COLOR) {
+        UniWinCore::set_key_color(_key_color);
+    }
+    // 边框会改变窗口样式，透明化需要在最终样式上进行
+    if (flags & DIRTY_BORDERLESS) {
+        UniWinCore::set_borderless(_is_borderless);
+    }
+    if (flags & DIRTY_TRANSPARENT) {
+        UniWinCore::set_transparent(_is_transparent);
+    }
+    if (flags & DIRTY_ALPHA) {
+        UniWinCore::set_alpha_value(_alpha_value);
+    }
+    
+    // 置顶和置底互斥：先解除再设置，避免中间状态相互覆盖
+    if ((flags & DIRTY_TOPMOST) && !_is_topmost) {
+        UniWinCore::set_topmost(false);
+    }
+    if ((flags & DIRTY_BOTTOMMOST) && !_is_bottommost) {
+        UniWinCore::set_bottommost(false);
+    }
+    if ((flags & DIRTY_TOPMOST) && _is_topmost) {
+        UniWinCore::set_topmost(true);
+    }
+    if ((flags & DIRTY_BOTTOMMOST) && _is_bottommost) {
+        UniWinCore::set_bottommost(true);
+    }
+    
+    // 先确定大小再移动，最大化放在最后以免被位置和大小覆盖
+    if (flags & DIRTY_SIZE) {
+        UniWinCore::set_size(_size.x, _size.y);
+    }
+    if (flags & DIRTY_POSITION) {
+        UniWinCore::set_position(_position.x, _position.y);
+    }
+    if (flags & DIRTY_ZOOMED) {
+        UniWinCore::set_zoomed(_is_zoomed);
+    }
+    
+    if (flags & DIRTY_HIT_TEST_TYPE) {
+        UniWinCore::set_hit_test_type(_hit_test_type);
+    }
+    if (flags & DIRTY_OPACITY_THRESHOLD) {
+        UniWinCore::set_opacity_threshold(_opacity_threshold);
+    }
+    if (flags & DIRTY_HIT_TEST_ENABLED) {
+        UniWinCore::set_hit_test_enabled(_hit_test_enabled);
+    }
+    // 点击穿透依赖透明状态
+    if (flags & DIRTY_CLICKTHROUGH) {
+        UniWinCore::set_clickthrough(_is_clickthrough);
+    }
+    if (flags & DIRTY_ALLOW_DROP_FILES) {
+        UniWinCore::set_allow_drop_files(_allow_drop_files);
     }
 }
 
 void UniWindowController::set_transparent(bool transparent) {
     _is_transparent = transparent;
-    if (_is_active) {
-        UniWinCore::set_transparent(transparent);
-    }
+    _mark_dirty(DIRTY_TRANSPARENT);
 }
 
 bool UniWindowController::get_transparent() const {
@@ -198,9 +694,7 @@ bool UniWindowController::get_transparent() const {
 
 void UniWindowController::set_borderless(bool borderless) {
     _is_borderless = borderless;
-    if (_is_active) {
-        UniWinCore::set_borderless(borderless);
-    }
+    _mark_dirty(DIRTY_BORDERLESS);
 }
 
 bool UniWindowController::get_borderless() const {
@@ -209,9 +703,7 @@ bool UniWindowController::get_borderless() const {
 
 void UniWindowController::set_topmost(bool topmost) {
     _is_topmost = topmost;
-    if (_is_active) {
-        UniWinCore::set_topmost(topmost);
-    }
+    _mark_dirty(DIRTY_TOPMOST);
 }
 
 bool UniWindowController::get_topmost() const {
@@ -220,9 +712,7 @@ bool UniWindowController::get_topmost() const {
 
 void UniWindowController::set_alpha_value(float alpha) {
     _alpha_value = Math::clamp(alpha, 0.0f, 1.0f);
-    if (_is_active) {
-        UniWinCore::set_alpha_value(_alpha_value);
-    }
+    _mark_dirty(DIRTY_ALPHA);
 }
 
 float UniWindowController::get_alpha_value() const {
@@ -231,13 +721,11 @@ float UniWindowController::get_alpha_value() const {
 
 void UniWindowController::set_position(Vector2 position) {
     _position = position;
-    if (_is_active) {
-        UniWinCore::set_position(position.x, position.y);
-    }
+    _mark_dirty(DIRTY_POSITION);
 }
 
 Vector2 UniWindowController::get_position() const {
-    if (_is_active) {
+    if (_is_active && !(_dirty_mask & DIRTY_POSITION)) {
         float x, y;
         UniWinCore::get_position(&x, &y);
         return Vector2(x, y);
@@ -247,13 +735,11 @@ Vector2 UniWindowController::get_position() const {
 
 void UniWindowController::set_size(Vector2 size) {
     _size = size;
-    if (_is_active) {
-        UniWinCore::set_size(size.x, size.y);
-    }
+    _mark_dirty(DIRTY_SIZE);
 }
 
 Vector2 UniWindowController::get_size() const {
-    if (_is_active) {
+    if (_is_active && !(_dirty_mask & DIRTY_SIZE)) {
         float width, height;
         UniWinCore::get_size(&width, &height);
         return Vector2(width, height);
@@ -278,7 +764,7 @@ int UniWindowController::get_monitor_count() const {
 }
 
 Vector2 UniWindowController::get_monitor_size(int monitor_index) const {
-    float width, height;
+    float width = 0.0f, height = 0.0f;
     UniWinCore::get_monitor_size(monitor_index, &width, &height);
     return Vector2(width, height);
 }
@@ -287,10 +773,38 @@ int UniWindowController::get_current_monitor() const {
     return UniWinCore::get_current_monitor();
 }
 
+PackedFloat32Array UniWindowController::get_monitor_rects() const {
+    const MonitorTopology& topology = UniWinCore::get_monitor_topology();
+    PackedFloat32Array rects;
+    rects.resize((int64_t)topology.monitors.size() * 4);
+    float* dst = rects.ptrw();
+    for (const MonitorRect& rect : topology.monitors) {
+        *dst++ = rect.x;
+        *dst++ = rect.y;
+        *dst++ = rect.width;
+        *dst++ = rect.height;
+    }
+    return rects;
+}
+
+Rect2 UniWindowController::get_virtual_desktop_rect() const {
+    const MonitorTopology& topology = UniWinCore::get_monitor_topology();
+    return Rect2(topology.virtual_x, topology.virtual_y, topology.virtual_width, topology.virtual_height);
+}
+
+float UniWindowController::get_monitor_dpi(int monitor_index) const {
+    const MonitorTopology& topology = UniWinCore::get_monitor_topology();
+    if (monitor_index < 0 || monitor_index >= (int)topology.monitors.size()) {
+        return 0.0f;
+    }
+    return topology.monitors[monitor_index].dpi;
+}
+
 void UniWindowController::_initialize_native() {
     if (!_is_initialized) {
         _is_initialized = UniWinCore::initialize();
         if (_is_initialized) {
+            g_initialized_controllers++;
             // 注册回调函数
             UniWinCore::register_drop_files_callback(_on_files_dropped);
             UniWinCore::register_focus_changed_callback(_on_window_focus_changed);
@@ -299,16 +813,18 @@ void UniWindowController::_initialize_native() {
             UniWinCore::register_monitor_changed_callback(_on_monitor_changed);
             
             // 修复Bug1：验证回调注册是否成功
-            UtilityFunctions::print("Callback registration completed:");
-            UtilityFunctions::print("  - Drop files callback registered");
-            UtilityFunctions::print("  - Focus changed callback registered");
-            UtilityFunctions::print("  - Window moved callback registered");
-            UtilityFunctions::print("  - Window resized callback registered");
-            UtilityFunctions::print("  - Monitor changed callback registered");
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "Callback registration completed:");
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "  - Drop files callback registered");
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "  - Focus changed callback registered");
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "  - Window moved callback registered");
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "  - Window resized callback registered");
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "  - Monitor changed callback registered");
             
-            UtilityFunctions::print("Native library initialized");
+            UniWinCore::set_async_commands(_async_window_commands);
+            
+            UNIWINC_LOG_INFO(UniWinLog::CATEGORY_CORE, "Native library initialized");
         } else {
-            UtilityFunctions::print("Failed to initialize native library");
+            UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_CORE, "Failed to initialize native library");
         }
     }
 }
@@ -316,8 +832,11 @@ void UniWindowController::_initialize_native() {
 void UniWindowController::_cleanup_native() {
     if (_is_initialized) {
         detach_window();
-        UniWinCore::cleanup();
         _is_initialized = false;
+        // 其他控制器仍在使用时保留native库
+        if (--g_initialized_controllers == 0) {
+            UniWinCore::cleanup();
+        }
     }
 }
 
@@ -326,80 +845,386 @@ void UniWindowController::_update_from_native() {
     // 这里可以添加需要定期更新的状态
 }
 
-// 静态回调函数 - 宽字符版本，直接emit signal
+// 静态回调函数 - 可能在任意线程调用，只把事件写入队列，由_process在主线程分发
 void UniWindowController::_on_files_dropped(const wchar_t* file_paths_w) {
-    UtilityFunctions::print("*** Drop files callback triggered ***");
-    if (!file_paths_w || !g_controller_instance) {
-        UtilityFunctions::print("ERROR: Invalid callback parameters");
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_DROP, "*** Drop files callback triggered ***");
+    if (!file_paths_w || g_attached_window_key.load(std::memory_order_acquire) == 0) {
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_DROP, "Invalid callback parameters");
         return;
     }
     
-    // 将宽字符串转换为UTF-8 (Godot使用UTF-8)
-    String file_paths_utf8;
+    // native的缓冲区只在回调期间有效，复制一份交给主线程
+    size_t length = wcslen(file_paths_w);
+    wchar_t* copy = new wchar_t[length + 1];
+    memcpy(copy, file_paths_w, (length + 1) * sizeof(wchar_t));
     
-#ifdef _WIN32
-    // Windows: 使用WideCharToMultiByte转换为UTF-8
-    int utf8_size = WideCharToMultiByte(CP_UTF8, 0, file_paths_w, -1, nullptr, 0, nullptr, nullptr);
-    if (utf8_size > 0) {
-        std::vector<char> utf8_buffer(utf8_size);
-        WideCharToMultiByte(CP_UTF8, 0, file_paths_w, -1, utf8_buffer.data(), utf8_size, nullptr, nullptr);
-        file_paths_utf8 = String::utf8(utf8_buffer.data());
+    NativeEvent event;
+    event.type = NativeEvent::FILES_DROPPED;
+    event.text = copy;
+    _post_native_event(event);
+}
+
+void UniWindowController::_on_window_focus_changed(bool focused) {
+    // 样式变化（最大化/最小化等）也通过此回调通知
+    UniWinCore::invalidate_window_state();
+    NativeEvent event;
+    event.type = NativeEvent::FOCUS_CHANGED;
+    event.value = focused ? 1 : 0;
+    _post_native_event(event);
+}
+
+void UniWindowController::_on_window_moved(float x, float y) {
+    UniWinCore::invalidate_window_state(WINDOW_STATE_POSITION);
+    NativeEvent event;
+    event.type = NativeEvent::WINDOW_MOVED;
+    event.x = x;
+    event.y = y;
+    _post_native_event(event);
+}
+
+void UniWindowController::_on_window_resized(float width, float height) {
+    // 最大化/还原也会改变大小
+    UniWinCore::invalidate_window_state(WINDOW_STATE_POSITION | WINDOW_STATE_SIZE | WINDOW_STATE_MAXIMIZED | WINDOW_STATE_ZOOMED);
+    NativeEvent event;
+    event.type = NativeEvent::WINDOW_RESIZED;
+    event.x = width;
+    event.y = height;
+    _post_native_event(event);
+}
+
+void UniWindowController::_on_monitor_changed(int monitor_index) {
+    UniWinCore::invalidate_window_state();
+    UniWinCore::invalidate_monitor_topology();
+    NativeEvent event;
+    event.type = NativeEvent::MONITOR_CHANGED;
+    event.value = monitor_index;
+    _post_native_event(event);
+}
+
+void UniWindowController::_post_native_event(NativeEvent event) {
+    event.window_key = g_attached_window_key.load(std::memory_order_acquire);
+    if (event.window_key == 0 || !g_native_events.push(event)) {
+        // 没有接收者或队列已满，丢弃事件
+        g_dropped_native_events.fetch_add(1, std::memory_order_relaxed);
+        delete[] event.text;
+    }
+}
+
+// 在主线程一次性分发本帧积累的所有native事件，按窗口句柄路由到对应控制器
+void UniWindowController::_dispatch_native_events() {
+    // 信号处理中可能释放控制器，这里只记录实例ID
+    std::vector<uint64_t> touched;
+    NativeEvent event;
+    while (g_native_events.pop(event)) {
+        UniWindowController* target = _find_controller(event.window_key);
+        if (!target) {
+            // 窗口已经分离，事件没有接收者
+            g_dropped_native_events.fetch_add(1, std::memory_order_relaxed);
+            delete[] event.text;
+            continue;
+        }
+        
+        uint64_t id = target->get_instance_id();
+        if (std::find(touched.begin(), touched.end(), id) == touched.end()) {
+            touched.push_back(id);
+        }
+        target->_handle_native_event(event);
+        delete[] event.text;
     }
-#else
-    // 非Windows: 使用标准库转换
-    std::wstring ws(file_paths_w);
-    std::string s(ws.begin(), ws.end());
-    file_paths_utf8 = String::utf8(s.c_str());
-#endif
-    
-    UtilityFunctions::print("Files received: " + file_paths_utf8);
-    
-    // 解析文件路径并直接emit signal
-    PackedStringArray files;
-    PackedStringArray lines = file_paths_utf8.split("\n");
     
-    for (int i = 0; i < lines.size(); i++) {
-        String path = lines[i].strip_edges();
-        if (!path.is_empty()) {
-            files.append(path);
+    for (uint64_t id : touched) {
+        UniWindowController* target = Object::cast_to<UniWindowController>(ObjectDB::get_instance(id));
+        if (target) {
+            target->_flush_coalesced_events();
         }
     }
+}
+
+void UniWindowController::_handle_native_event(NativeEvent& event) {
+    switch (event.type) {
+        case NativeEvent::FILES_DROPPED:
+            if (_drop_chunk_size > 0) {
+                // 接管路径缓冲区，之后每帧解析一块
+                _pending_drops.emplace_back(event.text);
+                event.text = nullptr;
+            } else {
+                _emit_files_dropped(UniWinPathListParser::parse_all(event.text));
+            }
+            break;
+        case NativeEvent::FOCUS_CHANGED:
+            // native注册的是窗口样式变化回调，最大化/还原也会触发
+            _fit_event_received = true;
+            emit_signal("window_focus_changed", event.value != 0);
+            break;
+        case NativeEvent::WINDOW_MOVED:
+            _position = Vector2(event.x, event.y);
+            _pending_moved_count++;
+            if (!_coalesce_window_events) {
+                _window_moved_event_count = 1;
+                emit_signal("window_moved", _position);
+            }
+            break;
+        case NativeEvent::WINDOW_RESIZED:
+            _fit_event_received = true;
+            _size = Vector2(event.x, event.y);
+            _pending_resized_count++;
+            if (!_coalesce_window_events) {
+                _window_resized_event_count = 1;
+                emit_signal("window_resized", _size);
+            }
+            break;
+        case NativeEvent::MONITOR_CHANGED:
+            emit_signal("monitor_changed", event.value);
+            break;
+    }
+}
+
+// 合并模式：每帧只发出最新的位置和大小
+void UniWindowController::_flush_coalesced_events() {
+    int moved_count = _pending_moved_count;
+    int resized_count = _pending_resized_count;
+    _pending_moved_count = 0;
+    _pending_resized_count = 0;
+    if (!_coalesce_window_events) {
+        return;
+    }
+    if (moved_count > 0) {
+        _window_moved_event_count = moved_count;
+        emit_signal("window_moved", _position);
+    }
+    if (resized_count > 0) {
+        _window_resized_event_count = resized_count;
+        emit_signal("window_resized", _size);
+    }
+}
+
+void UniWindowController::set_resolve_dropped_files(bool enabled) {
+    _resolve_dropped_files = enabled;
+    if (enabled && !_drop_resolver) {
+        _drop_resolver.reset(new UniWinDropResolver());
+    }
+}
+
+bool UniWindowController::get_resolve_dropped_files() const {
+    return _resolve_dropped_files;
+}
+
+void UniWindowController::set_drop_resolve_depth(int depth) {
+    _drop_resolve_depth = MAX(depth, 0);
+}
+
+int UniWindowController::get_drop_resolve_depth() const {
+    return _drop_resolve_depth;
+}
+
+void UniWindowController::set_drop_resolve_max_entries(int max_entries) {
+    _drop_resolve_max_entries = MAX(max_entries, 0);
+}
+
+int UniWindowController::get_drop_resolve_max_entries() const {
+    return _drop_resolve_max_entries;
+}
+
+void UniWindowController::set_drop_resolve_filters(const PackedStringArray& filters) {
+    _drop_resolve_filters = FileFilter::parse_pairs(filters);
+}
+
+void UniWindowController::set_drag_poll_rate(int rate) {
+    _drag_poll_rate = MAX(rate, 1);
+}
+
+int UniWindowController::get_drag_poll_rate() const {
+    return _drag_poll_rate;
+}
+
+void UniWindowController::set_drag_disable_on_zoomed(bool disable) {
+    _drag_disable_on_zoomed = disable;
+}
+
+bool UniWindowController::get_drag_disable_on_zoomed() const {
+    return _drag_disable_on_zoomed;
+}
+
+void UniWindowController::set_drag_prediction_horizon(double milliseconds) {
+    _drag_prediction_horizon = MAX(milliseconds, 0.0);
+}
+
+double UniWindowController::get_drag_prediction_horizon() const {
+    return _drag_prediction_horizon;
+}
+
+void UniWindowController::set_drag_prediction_max_distance(float distance) {
+    _drag_prediction_max_distance = MAX(distance, 0.0f);
+}
+
+float UniWindowController::get_drag_prediction_max_distance() const {
+    return _drag_prediction_max_distance;
+}
+
+void UniWindowController::set_drag_prediction_use_acceleration(bool enabled) {
+    _drag_prediction_use_acceleration = enabled;
+}
+
+bool UniWindowController::get_drag_prediction_use_acceleration() const {
+    return _drag_prediction_use_acceleration;
+}
+
+Dictionary UniWindowController::get_drag_error_stats() const {
+    UniWinWindowDragger::ErrorStats stats;
+    if (_window_dragger) {
+        stats = _window_dragger->get_error_stats();
+    }
+    Dictionary result;
+    result["mean"] = stats.mean;
+    result["max"] = stats.max;
+    result["last"] = stats.last;
+    result["samples"] = stats.samples;
+    return result;
+}
+
+bool UniWindowController::start_window_drag() {
+    if (!_is_active) {
+        return false;
+    }
+    // Unity版本的IsZoomed：shouldFitMonitor时也视为最大化
+    if (_drag_disable_on_zoomed && (_should_fit_monitor || UniWinCore::is_zoomed())) {
+        return false;
+    }
+    if (DisplayServer::get_singleton()->window_get_mode() == DisplayServer::WINDOW_MODE_FULLSCREEN) {
+        return false;
+    }
+    if (!_window_dragger) {
+        _window_dragger = std::make_unique<UniWinWindowDragger>();
+    }
     
-    if (files.size() > 0) {
-        UtilityFunctions::print("Emitting files_dropped signal with " + String::num_int64(files.size()) + " files");
-        g_controller_instance->emit_signal("files_dropped", files);
-        UtilityFunctions::print("Signal emitted successfully");
-    } else {
-        UtilityFunctions::print("WARNING: No valid files found in dropped files");
+    UniWinWindowDragger::Settings settings;
+    settings.poll_rate = _drag_poll_rate;
+    settings.disable_on_zoomed = _drag_disable_on_zoomed;
+    settings.prediction_horizon = _drag_prediction_horizon / 1000.0;
+    settings.prediction_max_distance = _drag_prediction_max_distance;
+    settings.prediction_use_acceleration = _drag_prediction_use_acceleration;
+    if (!_window_dragger->start(settings)) {
+        return false;
     }
+    emit_signal("window_drag_started");
+    return true;
 }
 
-void UniWindowController::_on_window_focus_changed(bool focused) {
-    if (g_controller_instance) {
-        g_controller_instance->emit_signal("window_focus_changed", focused);
+void UniWindowController::stop_window_drag() {
+    if (!_window_dragger) {
+        return;
+    }
+    bool was_dragging = _window_dragger->is_dragging();
+    was_dragging = _window_dragger->take_ended() || was_dragging;
+    _window_dragger->stop();
+    if (was_dragging) {
+        emit_signal("window_drag_ended");
     }
 }
 
-void UniWindowController::_on_window_moved(float x, float y) {
-    if (g_controller_instance) {
-        g_controller_instance->_position = Vector2(x, y);
-        g_controller_instance->emit_signal("window_moved", g_controller_instance->_position);
+bool UniWindowController::is_window_dragging() const {
+    return _window_dragger && _window_dragger->is_dragging();
+}
+
+void UniWindowController::_process_window_drag() {
+    if (!_window_dragger) {
+        return;
+    }
+    Vector2 target;
+    if (_window_dragger->take_target(&target)) {
+        _position = target;
+        UniWinCore::set_position(target.x, target.y);
+    }
+    if (_window_dragger->is_dragging() &&
+            (DisplayServer::get_singleton()->window_get_mode() == DisplayServer::WINDOW_MODE_FULLSCREEN ||
+             !_window_dragger->update())) {
+        stop_window_drag();
+        return;
+    }
+    if (_window_dragger->take_ended()) {
+        emit_signal("window_drag_ended");
     }
 }
 
-void UniWindowController::_on_window_resized(float width, float height) {
-    if (g_controller_instance) {
-        g_controller_instance->_size = Vector2(width, height);
-        g_controller_instance->emit_signal("window_resized", g_controller_instance->_size);
+PackedStringArray UniWindowController::get_drop_resolve_filters() const {
+    PackedStringArray result;
+    for (const FileFilter& filter : _drop_resolve_filters) {
+        result.append(filter.title);
+        result.append(String(";").join(filter.extensions));
     }
+    return result;
 }
 
-void UniWindowController::_on_monitor_changed(int monitor_index) {
-    if (g_controller_instance) {
-        g_controller_instance->emit_signal("monitor_changed", monitor_index);
+void UniWindowController::set_drop_chunk_size(int size) {
+    _drop_chunk_size = MAX(size, 0);
+}
+
+int UniWindowController::get_drop_chunk_size() const {
+    return _drop_chunk_size;
+}
+
+void UniWindowController::set_coalesce_window_events(bool enabled) {
+    _coalesce_window_events = enabled;
+}
+
+bool UniWindowController::get_coalesce_window_events() const {
+    return _coalesce_window_events;
+}
+
+int UniWindowController::get_window_moved_event_count() const {
+    return _window_moved_event_count;
+}
+
+int UniWindowController::get_window_resized_event_count() const {
+    return _window_resized_event_count;
+}
+
+void UniWindowController::_discard_native_events() {
+    NativeEvent event;
+    while (g_native_events.pop(event)) {
+        delete[] event.text;
     }
 }
 
+int64_t UniWindowController::get_dropped_native_event_count() const {
+    return (int64_t)g_dropped_native_events.load(std::memory_order_relaxed);
+}
+
+void UniWindowController::_emit_files_dropped(const PackedStringArray& files) {
+    if (files.size() > 0) {
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_DROP, "Emitting files_dropped signal with " + String::num_int64(files.size()) + " files");
+        emit_signal("files_dropped", files);
+        if (_resolve_dropped_files && _drop_resolver) {
+            _drop_resolver->submit(files, _drop_resolve_depth, _drop_resolve_filters, _drop_resolve_max_entries);
+        }
+    } else {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_DROP, "No valid files found in dropped files");
+    }
+}
+
+// 分块模式：每帧解析并发出一块，最后一块之后再发出完整的files_dropped
+void UniWindowController::_process_pending_drops() {
+    if (_pending_drops.empty()) {
+        return;
+    }
+    
+    PendingDrop& drop = _pending_drops.front();
+    int64_t begin = drop.count;
+    drop.parser.parse(drop.files, &drop.count, MAX(_drop_chunk_size, 1));
+    bool is_last = drop.parser.is_done();
+    
+    if (drop.count > begin || is_last) {
+        emit_signal("files_dropped_chunk", drop.files.slice(begin, drop.count), drop.chunk_index, is_last);
+        drop.chunk_index++;
+    }
+    
+    if (is_last) {
+        drop.files.resize(drop.count);
+        PackedStringArray files = drop.files;
+        _pending_drops.pop_front();
+        _emit_files_dropped(files);
+    }
+}
 
 // 新增的窗口控制方法实现
 void UniWindowController::set_window_title(const String& title) {
@@ -415,21 +1240,21 @@ String UniWindowController::get_window_title() const {
 void UniWindowController::minimize_window() {
     if (_is_active) {
         // UniWinCore::minimize_window();
-        UtilityFunctions::print("Window minimized");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "Window minimized");
     }
 }
 
 void UniWindowController::maximize_window() {
     if (_is_active) {
         // UniWinCore::maximize_window();
-        UtilityFunctions::print("Window maximized");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "Window maximized");
     }
 }
 
 void UniWindowController::restore_window() {
     if (_is_active) {
         // UniWinCore::restore_window();
-        UtilityFunctions::print("Window restored");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "Window restored");
     }
 }
 
@@ -454,9 +1279,7 @@ float UniWindowController::get_window_opacity() const {
 // Unity兼容的新增方法实现
 void UniWindowController::set_bottommost(bool bottommost) {
     _is_bottommost = bottommost;
-    if (_is_active) {
-        UniWinCore::set_bottommost(bottommost);
-    }
+    _mark_dirty(DIRTY_BOTTOMMOST);
 }
 
 bool UniWindowController::get_bottommost() const {
@@ -465,13 +1288,11 @@ bool UniWindowController::get_bottommost() const {
 
 void UniWindowController::set_zoomed(bool zoomed) {
     _is_zoomed = zoomed;
-    if (_is_active) {
-        UniWinCore::set_zoomed(zoomed);
-    }
+    _mark_dirty(DIRTY_ZOOMED);
 }
 
 bool UniWindowController::get_zoomed() const {
-    if (_is_active) {
+    if (_is_active && !(_dirty_mask & DIRTY_ZOOMED)) {
         return UniWinCore::is_zoomed();
     }
     return _is_zoomed;
@@ -503,110 +1324,184 @@ void UniWindowController::set_monitor_to_fit(int monitor_index) {
     }
 }
 
+bool UniWindowController::fit_to_all_monitors() {
+    const MonitorTopology& topology = UniWinCore::get_monitor_topology();
+    if (topology.monitors.empty()) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_MONITOR, "Cannot fit to all monitors: no monitor information");
+        return false;
+    }
+    return _fit_to_rect(Rect2(topology.virtual_x, topology.virtual_y, topology.virtual_width, topology.virtual_height));
+}
+
+bool UniWindowController::fit_to_monitor_set(const PackedInt32Array& monitor_indices) {
+    const MonitorTopology& topology = UniWinCore::get_monitor_topology();
+    Rect2 bounds;
+    bool has_bounds = false;
+    for (int i = 0; i < monitor_indices.size(); i++) {
+        int index = monitor_indices[i];
+        if (index < 0 || index >= (int)topology.monitors.size()) {
+            UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_MONITOR, "Ignoring invalid monitor index: " + String::num_int64(index));
+            continue;
+        }
+        const MonitorRect& monitor = topology.monitors[index];
+        Rect2 rect(monitor.x, monitor.y, monitor.width, monitor.height);
+        bounds = has_bounds ? bounds.merge(rect) : rect;
+        has_bounds = true;
+    }
+    if (!has_bounds) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_MONITOR, "Cannot fit to monitor set: no valid monitor");
+        return false;
+    }
+    return _fit_to_rect(bounds);
+}
+
+void UniWindowController::set_window_rect(const Rect2& rect) {
+    if (!_is_active) {
+        return;
+    }
+    UniWinCore::set_window_rect(rect.position.x, rect.position.y, rect.size.x, rect.size.y);
+}
+
+bool UniWindowController::_fit_to_rect(const Rect2& rect) {
+    if (!_is_active) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_MONITOR, "Cannot fit window: window not active");
+        return false;
+    }
+    // 最大化状态下窗口管理器会忽略尺寸，先还原
+    if (UniWinCore::is_zoomed()) {
+        UniWinCore::set_zoomed(false);
+    }
+    UniWinCore::set_window_rect(rect.position.x, rect.position.y, rect.size.x, rect.size.y);
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "Window fitted to rect: " + String(Variant(rect)));
+    return true;
+}
+
 // 修复Bug2：实现完整的fit_to_monitor逻辑，复制Unity版本的实现
 void UniWindowController::fit_to_monitor(int monitor_index) {
     if (!_is_active) {
-        UtilityFunctions::print("Cannot fit to monitor: window not active");
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_MONITOR, "Cannot fit to monitor: window not active");
         return;
     }
     
     // 获取监视器数量并验证索引
     int monitor_count = get_monitor_count();
-    int target_monitor = monitor_index;
+    int target_monitor = MIN(MAX(monitor_index, 0), monitor_count - 1);
+    if (target_monitor < 0) {
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_MONITOR, "Invalid monitor index: " + String::num_int64(monitor_index));
+        return;
+    }
     
-    UtilityFunctions::print("Fitting to monitor " + String::num_int64(monitor_index) + " (total monitors: " + String::num_int64(monitor_count) + ")");
+    if (UniWinCore::get_async_commands()) {
+        // 异步模式：整个适配流程在命令线程中执行，完成后发出window_command_completed和fit_completed
+        UniWinCore::fit_to_monitor(target_monitor);
+        return;
+    }
     
-    if (target_monitor < 0) {
-        target_monitor = 0;
+    if (_fit_state != FIT_IDLE) {
+        _finish_fit(false);  // 新的请求取代进行中的适配
     }
-    if (target_monitor >= monitor_count) {
-        target_monitor = monitor_count - 1;
+    
+    float dx = 0.0f, dy = 0.0f, dw = 0.0f, dh = 0.0f;
+    UniWinCore::get_monitor_rectangle(target_monitor, &dx, &dy, &dw, &dh);
+    _fit_monitor = target_monitor;
+    _fit_monitor_rect = Rect2(dx, dy, dw, dh);
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "Fitting to monitor " + String::num_int64(target_monitor) + ": " + String(Variant(_fit_monitor_rect)));
+    
+    // 与Unity版本相同：已最大化时先还原，等状态生效后再移动
+    if (UniWinCore::is_zoomed()) {
+        set_zoomed(false);
+        _enter_fit_state(FIT_WAIT_RESTORE);
+    } else {
+        _enter_fit_state(FIT_WAIT_ZOOM);
     }
+}
+
+void UniWindowController::set_fit_timeout(double seconds) {
+    _fit_timeout = MAX(seconds, 0.0);
+}
+
+double UniWindowController::get_fit_timeout() const {
+    return _fit_timeout;
+}
+
+bool UniWindowController::is_fitting() const {
+    return _fit_state != FIT_IDLE;
+}
+
+void UniWindowController::_enter_fit_state(FitState state) {
+    _fit_state = state;
+    _fit_elapsed = 0.0;
+    _fit_event_received = false;
     
-    if (target_monitor >= 0) {
-        // 复制Unity版本FitToMonitor的完整逻辑
-        float dx, dy, dw, dh;
-        UniWinCore::get_monitor_rectangle(target_monitor, &dx, &dy, &dw, &dh);
-        
-        UtilityFunctions::print("Monitor " + String::num_int64(target_monitor) + " rectangle: " + 
-                              String::num(dx) + ", " + String::num(dy) + " - " + 
-                              String::num(dw) + "x" + String::num(dh));
-        
-        // 如果当前已经最大化，先解除最大化（Unity版本逻辑）
-        bool was_maximized = is_maximized();
-        if (was_maximized) {
-            UtilityFunctions::print("Window was maximized, restoring first...");
-            set_zoomed(false);
-            // 等待一帧让状态更新
-            // 注意：这里可能需要异步处理
-        }
-        
-        // 计算监视器中央位置
-        float cx = dx + (dw / 2.0f);
-        float cy = dy + (dh / 2.0f);
-        
-        // 获取当前窗口大小
-        float ww, wh;
-        UniWinCore::get_size(&ww, &wh);
-        
-        UtilityFunctions::print("Current window size: " + String::num(ww) + "x" + String::num(wh));
-        
-        // 将窗口中央移动到指定监视器中央
-        float wx = cx - (ww / 2.0f);
-        float wy = cy - (wh / 2.0f);
-        
-        UtilityFunctions::print("Moving window to position: " + String::num(wx) + ", " + String::num(wy));
-        set_position(Vector2(wx, wy));
-        
-        // 最大化窗口（Unity版本逻辑）- 这是关键步骤
-        UtilityFunctions::print("Maximizing window...");
+    if (state == FIT_WAIT_ZOOM) {
+        // 窗口中央移到监视器中央，再最大化
+        Vector2 window_size = get_size();
+        set_position(_fit_monitor_rect.get_center() - window_size / 2.0f);
         set_zoomed(true);
-        
-        // 验证最大化是否成功
-        bool is_now_maximized = is_maximized();
-        UtilityFunctions::print("Window maximization result: " + String(is_now_maximized ? "SUCCESS" : "FAILED"));
-        
-        if (!is_now_maximized) {
-            // 如果最大化失败，尝试直接设置窗口大小为监视器大小
-            UtilityFunctions::print("Maximization failed, trying to set window size to monitor size...");
-            
-            // 方法1: 先设置窗口位置到监视器左上角，然后设置大小
-            set_position(Vector2(dx, dy));
-            set_size(Vector2(dw, dh));
-            
-            // 等待一下让设置生效
-            // TODO: 在实际应用中可能需要异步等待
-            
-            // 验证设置是否成功
-            Vector2 new_pos = get_position();
-            Vector2 new_size = get_size();
-            UtilityFunctions::print("Fallback result - Position: " + String::num(new_pos.x) + ", " + String::num(new_pos.y) + 
-                                  " Size: " + String::num(new_size.x) + "x" + String::num(new_size.y));
-            
-            // 如果还是不对，尝试第二种方法：使用Godot的窗口API
-            if (abs(new_size.x - dw) > 10 || abs(new_size.y - dh) > 10) {
-                UtilityFunctions::print("Size setting via native failed, this suggests native library issues");
-                UtilityFunctions::print("Monitor fitting completed with potential size mismatch");
-            } else {
-                UtilityFunctions::print("Fallback size setting successful");
+    } else if (state == FIT_WAIT_FALLBACK) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_MONITOR, "Maximization did not take effect, sizing window to the monitor instead");
+        UniWinCore::set_window_rect(_fit_monitor_rect.position.x, _fit_monitor_rect.position.y,
+                _fit_monitor_rect.size.x, _fit_monitor_rect.size.y);
+    }
+}
+
+void UniWindowController::_process_fit(double delta) {
+    if (_fit_state == FIT_IDLE) {
+        return;
+    }
+    _fit_elapsed += delta;
+    bool timed_out = _fit_elapsed >= _fit_timeout;
+    // 只在回调到达或超时后读取状态，避免读到OS尚未应用的旧值
+    if (!_fit_event_received && !timed_out) {
+        return;
+    }
+    _fit_event_received = false;
+    
+    switch (_fit_state) {
+        case FIT_WAIT_RESTORE:
+            if (!UniWinCore::is_zoomed() || timed_out) {
+                _enter_fit_state(FIT_WAIT_ZOOM);
             }
+            break;
+        case FIT_WAIT_ZOOM:
+            if (UniWinCore::is_maximized()) {
+                _finish_fit(true);
+            } else if (timed_out) {
+                _enter_fit_state(FIT_WAIT_FALLBACK);
+            }
+            break;
+        case FIT_WAIT_FALLBACK: {
+            Vector2 size = get_size();
+            bool matched = Math::abs(size.x - _fit_monitor_rect.size.x) <= 10.0f &&
+                    Math::abs(size.y - _fit_monitor_rect.size.y) <= 10.0f;
+            if (matched || timed_out) {
+                if (!matched) {
+                    UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_MONITOR, "Monitor fitting completed with size mismatch: " + String(Variant(size)));
+                }
+                _finish_fit(matched);
+            }
+            break;
         }
-        
-        UtilityFunctions::print("Fit window to monitor " + String::num_int64(target_monitor) + " completed");
-    } else {
-        UtilityFunctions::print("Invalid monitor index: " + String::num_int64(target_monitor));
+        default:
+            break;
     }
 }
 
+void UniWindowController::_finish_fit(bool success) {
+    int monitor = _fit_monitor;
+    _fit_state = FIT_IDLE;
+    _fit_monitor = -1;
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "Fit window to monitor " + String::num_int64(monitor) + (success ? " completed" : " failed"));
+    emit_signal("fit_completed", monitor, success);
+}
+
 int UniWindowController::get_monitor_to_fit() const {
     return _monitor_to_fit;
 }
 
 void UniWindowController::set_transparent_type(int type) {
     _transparent_type = type;
-    if (_is_active) {
-        UniWinCore::set_transparent_type(type);
-    }
+    _mark_dirty(DIRTY_TRANSPARENT_TYPE);
 }
 
 int UniWindowController::get_transparent_type() const {
@@ -615,9 +1510,7 @@ int UniWindowController::get_transparent_type() const {
 
 void UniWindowController::set_key_color(const Color& color) {
     _key_color = color;
-    if (_is_active) {
-        UniWinCore::set_key_color(color);
-    }
+    _mark_dirty(DIRTY_KEY_COLOR);
 }
 
 Color UniWindowController::get_key_color() const {
@@ -626,9 +1519,7 @@ Color UniWindowController::get_key_color() const {
 
 void UniWindowController::set_hit_test_type(int type) {
     _hit_test_type = type;
-    if (_is_active) {
-        UniWinCore::set_hit_test_type(type);
-    }
+    _mark_dirty(DIRTY_HIT_TEST_TYPE);
 }
 
 int UniWindowController::get_hit_test_type() const {
@@ -637,9 +1528,7 @@ int UniWindowController::get_hit_test_type() const {
 
 void UniWindowController::set_opacity_threshold(float threshold) {
     _opacity_threshold = Math::clamp(threshold, 0.0f, 1.0f);
-    if (_is_active) {
-        UniWinCore::set_opacity_threshold(_opacity_threshold);
-    }
+    _mark_dirty(DIRTY_OPACITY_THRESHOLD);
 }
 
 float UniWindowController::get_opacity_threshold() const {
@@ -648,9 +1537,7 @@ float UniWindowController::get_opacity_threshold() const {
 
 void UniWindowController::set_hit_test_enabled(bool enabled) {
     _hit_test_enabled = enabled;
-    if (_is_active) {
-        UniWinCore::set_hit_test_enabled(enabled);
-    }
+    _mark_dirty(DIRTY_HIT_TEST_ENABLED);
 }
 
 bool UniWindowController::get_hit_test_enabled() const {
@@ -659,9 +1546,7 @@ bool UniWindowController::get_hit_test_enabled() const {
 
 void UniWindowController::set_clickthrough(bool clickthrough) {
     _is_clickthrough = clickthrough;
-    if (_is_active) {
-        UniWinCore::set_clickthrough(clickthrough);
-    }
+    _mark_dirty(DIRTY_CLICKTHROUGH);
 }
 
 bool UniWindowController::get_clickthrough() const {
@@ -670,9 +1555,7 @@ bool UniWindowController::get_clickthrough() const {
 
 void UniWindowController::set_allow_drop_files(bool allow) {
     _allow_drop_files = allow;
-    if (_is_active) {
-        UniWinCore::set_allow_drop_files(allow);
-    }
+    _mark_dirty(DIRTY_ALLOW_DROP_FILES);
 }
 
 bool UniWindowController::get_allow_drop_files() const {
@@ -680,16 +1563,15 @@ bool UniWindowController::get_allow_drop_files() const {
 }
 
 Vector2 UniWindowController::get_monitor_position(int monitor_index) const {
-    float x, y;
+    float x = 0.0f, y = 0.0f;
     UniWinCore::get_monitor_position(monitor_index, &x, &y);
     return Vector2(x, y);
 }
 
 // 静态方法实现
 Vector2 UniWindowController::get_cursor_position() {
-    float x, y;
-    UniWinCore::get_cursor_position(&x, &y);
-    return Vector2(x, y);
+    const InputSample& sample = UniWinCore::get_input_sample();
+    return Vector2(sample.x, sample.y);
 }
 
 void UniWindowController::set_cursor_position(Vector2 position) {
@@ -697,9 +1579,71 @@ void UniWindowController::set_cursor_position(Vector2 position) {
 }
 
 int UniWindowController::get_mouse_buttons() {
-    return UniWinCore::get_mouse_buttons();
+    return UniWinCore::get_input_sample().buttons;
 }
 
 int UniWindowController::get_modifier_keys() {
-    return UniWinCore::get_modifier_keys();
+    return UniWinCore::get_input_sample().modifiers;
+}
+
+int UniWindowController::get_capabilities() {
+    return UniWinCore::get_capabilities();
+}
+
+bool UniWindowController::has_capability(int capabilities) {
+    return UniWinCore::has_capability(capabilities);
+}
+
+void UniWindowController::add_startup_phase(const String& name, int64_t start_ticks_usec, int64_t end_ticks_usec) {
+    if (!UniWinStartupTrace::is_recording()) {
+        return;
+    }
+    UniWinStartupTrace::add_phase(name.utf8().get_data(),
+            UniWinStartupTrace::from_engine_ticks(start_ticks_usec),
+            UniWinStartupTrace::from_engine_ticks(end_ticks_usec));
+}
+
+void UniWindowController::finish_startup_trace() {
+    UniWinStartupTrace::mark("startup finished");
+    UniWinStartupTrace::finish();
+}
+
+Dictionary UniWindowController::get_startup_timeline() {
+    return UniWinStartupTrace::get_timeline();
+}
+
+String UniWindowController::get_startup_trace_json() {
+    return UniWinStartupTrace::get_chrome_trace_json();
+}
+
+void UniWindowController::set_input_sample_rate(int rate) {
+    UniWinCore::set_input_sample_rate(rate);
+}
+
+int UniWindowController::get_input_sample_rate() {
+    return UniWinCore::get_input_sample_rate();
+}
+
+void UniWindowController::set_input_history_size(int size) {
+    UniWinCore::set_input_history_size(size);
+}
+
+int UniWindowController::get_input_history_size() {
+    return UniWinCore::get_input_history_size();
+}
+
+PackedFloat64Array UniWindowController::get_input_history() {
+    int count = UniWinCore::get_input_history_count();
+    PackedFloat64Array result;
+    result.resize(count * 5);
+    double* data = result.ptrw();
+    for (int i = 0; i < count; i++) {
+        const InputSample& sample = UniWinCore::get_input_history_sample(count - 1 - i);
+        data[i * 5 + 0] = sample.time_usec / 1000000.0;
+        data[i * 5 + 1] = sample.x;
+        data[i * 5 + 2] = sample.y;
+        data[i * 5 + 3] = sample.buttons;
+        data[i * 5 + 4] = sample.modifiers;
+    }
+    return result;
 }
\ No newline at end of file
@@ -3,14 +3,50 @@
 
 #include <godot_cpp/classes/node.hpp>
 #include <godot_cpp/variant/vector2.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
 #include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/rect2.hpp>
 #include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include "uniwinc_drop_resolver.h"
+#include "uniwinc_file_dialog.h"
+#include "uniwinc_path_list.h"
+#include "uniwinc_window_dragger.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
 
 using namespace godot;
 
+// native库同一时间只附加一个窗口，多个控制器（多个Window）不会被独立驱动：
+// 最后附加的控制器拥有native窗口，之前的控制器变为非活动状态，需要重新attach_window才能接管
+// native库只能附加进程自己的主窗口（不能按句柄附加），位于独立子Window中的控制器拒绝附加；
+// 注册表的键和命令线程使用的句柄都是主窗口的句柄
 class UniWindowController : public Node {
     GDCLASS(UniWindowController, Node)
 
+public:
+    // native回调事件（回调线程写入，主线程读取）
+    struct NativeEvent {
+        enum Type {
+            FILES_DROPPED,
+            FOCUS_CHANGED,
+            WINDOW_MOVED,
+            WINDOW_RESIZED,
+            MONITOR_CHANGED
+        };
+        Type type = FOCUS_CHANGED;
+        float x = 0.0f;
+        float y = 0.0f;
+        int value = 0;
+        wchar_t* text = nullptr;    // FILES_DROPPED的路径列表，由主线程释放
+        int64_t window_key = 0;     // 产生事件的窗口句柄
+    };
+
 private:
     // 窗口状态
     bool _is_transparent = false;
@@ -37,6 +73,97 @@ private:
     // 内部状态
     bool _is_active = false;
     bool _is_initialized = false;
+    
+    // 批量更新事务：begin_update()期间只记录脏标记，commit()时按依赖顺序一次性应用
+    enum DirtyFlag {
+        DIRTY_TRANSPARENT_TYPE = 1 << 0,
+        DIRTY_KEY_COLOR = 1 << 1,
+        DIRTY_BORDERLESS = 1 << 2,
+        DIRTY_TRANSPARENT = 1 << 3,
+        DIRTY_ALPHA = 1 << 4,
+        DIRTY_TOPMOST = 1 << 5,
+        DIRTY_BOTTOMMOST = 1 << 6,
+        DIRTY_SIZE = 1 << 7,
+        DIRTY_POSITION = 1 << 8,
+        DIRTY_ZOOMED = 1 << 9,
+        DIRTY_HIT_TEST_TYPE = 1 << 10,
+        DIRTY_OPACITY_THRESHOLD = 1 << 11,
+        DIRTY_HIT_TEST_ENABLED = 1 << 12,
+        DIRTY_CLICKTHROUGH = 1 << 13,
+        DIRTY_ALLOW_DROP_FILES = 1 << 14
+    };
+    int _update_depth = 0;
+    uint32_t _dirty_mask = 0;
+    
+    // 异步窗口命令模式
+    bool _async_window_commands = false;
+    
+    // fit_to_monitor状态机：每一步等窗口回调确认（或超时）后再执行下一步
+    enum FitState {
+        FIT_IDLE,
+        FIT_WAIT_RESTORE,   // 已请求解除最大化
+        FIT_WAIT_ZOOM,      // 已移到监视器中央并请求最大化
+        FIT_WAIT_FALLBACK   // 最大化未生效，已直接设置为监视器矩形
+    };
+    FitState _fit_state = FIT_IDLE;
+    int _fit_monitor = -1;
+    Rect2 _fit_monitor_rect;
+    double _fit_elapsed = 0.0;
+    double _fit_timeout = 0.5;
+    bool _fit_event_received = false;
+    
+    // 异步附加：失败后按指数退避在之后的帧重试，超过attach_timeout放弃
+    bool _attach_pending = false;
+    int _attach_attempts = 0;
+    uint64_t _attach_start_frame = 0;
+    double _attach_elapsed = 0.0;
+    double _attach_next_attempt = 0.0;      // 下一次尝试的时间（相对开始，秒）
+    double _attach_delay = 0.0;             // 当前退避间隔
+    double _attach_retry_delay = 0.016;     // 第一次重试前的间隔
+    double _attach_max_retry_delay = 0.5;
+    double _attach_timeout = 5.0;
+    int _attach_frame_count = -1;           // 最近一次异步附加用了多少帧，-1为尚未完成
+    
+    // 移动/缩放事件合并（最近一次发出的信号合并了多少个原始事件）
+    bool _coalesce_window_events = true;
+    int _window_moved_event_count = 0;
+    int _window_resized_event_count = 0;
+    int _pending_moved_count = 0;
+    int _pending_resized_count = 0;
+    
+    // 分块处理中的拖放（拥有native路径缓冲区的副本）
+    struct PendingDrop {
+        std::unique_ptr<wchar_t[]> text;
+        UniWinPathListParser parser;
+        PackedStringArray files;
+        int64_t count = 0;
+        int chunk_index = 0;
+        
+        explicit PendingDrop(wchar_t* p_text) :
+                text(p_text), parser(p_text) {
+            files.resize(parser.count_segments());
+        }
+    };
+    int _drop_chunk_size = 0;     // 0表示不分块
+    std::deque<PendingDrop> _pending_drops;
+    
+    // 拖放文件的后台元数据解析（启用时才创建线程池）
+    bool _resolve_dropped_files = false;
+    int _drop_resolve_depth = 0;
+    int _drop_resolve_max_entries = 10000;
+    std::vector<FileFilter> _drop_resolve_filters;
+    std::unique_ptr<UniWinDropResolver> _drop_resolver;
+    
+    // 原生窗口拖动（开始拖动时才创建）
+    int _drag_poll_rate = 240;
+    bool _drag_disable_on_zoomed = true;
+    double _drag_prediction_horizon = 0.0;    // 毫秒，0为不预测
+    float _drag_prediction_max_distance = 48.0f;
+    bool _drag_prediction_use_acceleration = true;
+    std::unique_ptr<UniWinWindowDragger> _window_dragger;
+    
+    // 在控制器注册表中的键（附加时所在窗口的native句柄，0表示未注册）
+    int64_t _window_key = 0;
 
 protected:
     static void _bind_methods();
@@ -53,6 +180,29 @@ public:
     bool attach_window();
     void detach_window();
     
+    // 非阻塞附加：立即尝试一次，失败时在之后的帧按指数退避重试，
+    // 结果通过window_attached/attach_failed(attempt_count, frame_count)发出；已在进行中时返回false
+    bool attach_window_async();
+    void cancel_attach();
+    bool is_attach_pending() const;
+    int get_attach_frame_count() const;
+    int get_attach_attempt_count() const;
+    void set_attach_retry_delay(double seconds);
+    double get_attach_retry_delay() const;
+    void set_attach_max_retry_delay(double seconds);
+    double get_attach_max_retry_delay() const;
+    void set_attach_timeout(double seconds);
+    double get_attach_timeout() const;
+    
+    // 批量属性更新（可嵌套，最外层commit时才调用native）
+    void begin_update();
+    void commit();
+    bool is_updating() const;
+    
+    // 异步窗口命令：位置/大小/最大化/适配监视器每帧合并一次，Windows上在命令线程中执行，其他平台在_process中执行
+    void set_async_window_commands(bool enabled);
+    bool get_async_window_commands() const;
+    
     // 基础属性访问器
     void set_transparent(bool transparent);
     bool get_transparent() const;
@@ -93,6 +243,15 @@ public:
     
     // 修复Bug2：添加fit_to_monitor方法声明
     void fit_to_monitor(int monitor_index);
+    // 跨多个监视器：按拓扑缓存计算外包矩形，位置和大小一次设置
+    // fit_to_monitor的每一步最多等待的秒数
+    void set_fit_timeout(double seconds);
+    double get_fit_timeout() const;
+    bool is_fitting() const;
+    
+    bool fit_to_all_monitors();
+    bool fit_to_monitor_set(const PackedInt32Array& monitor_indices);
+    void set_window_rect(const Rect2& rect);
     
     void set_transparent_type(int type);
     int get_transparent_type() const;
@@ -129,26 +288,115 @@ public:
     bool is_maximized() const;
     bool is_minimized() const;
     
+    // 拖放文件超过该数量时分多帧发出files_dropped_chunk，0为不分块
+    void set_drop_chunk_size(int size);
+    int get_drop_chunk_size() const;
+    
+    // 拖放文件的后台解析：stat、目录展开和扩展名过滤在线程池中进行，完成后发出files_dropped_resolved
+    void set_resolve_dropped_files(bool enabled);
+    bool get_resolve_dropped_files() const;
+    void set_drop_resolve_depth(int depth);
+    int get_drop_resolve_depth() const;
+    void set_drop_resolve_max_entries(int max_entries);
+    int get_drop_resolve_max_entries() const;
+    void set_drop_resolve_filters(const PackedStringArray& filters);  // 与UniWinFileDialog.filters格式相同
+    PackedStringArray get_drop_resolve_filters() const;
+    
+    // 原生窗口拖动：开始后在独立线程按drag_poll_rate读取光标并移动窗口，松开左键时结束
+    void set_drag_poll_rate(int rate);
+    int get_drag_poll_rate() const;
+    void set_drag_disable_on_zoomed(bool disable);
+    bool get_drag_disable_on_zoomed() const;
+    // 拖动预测：按最近的光标速度/加速度外推horizon毫秒，位移不超过max_distance像素
+    void set_drag_prediction_horizon(double milliseconds);
+    double get_drag_prediction_horizon() const;
+    void set_drag_prediction_max_distance(float distance);
+    float get_drag_prediction_max_distance() const;
+    void set_drag_prediction_use_acceleration(bool enabled);
+    bool get_drag_prediction_use_acceleration() const;
+    // 光标与窗口偏差统计：{mean, max, last, samples}（像素）
+    Dictionary get_drag_error_stats() const;
+    bool start_window_drag();
+    void stop_window_drag();
+    bool is_window_dragging() const;
+    
+    // 控制器所在窗口的native句柄（注册表的键）
+    int64_t get_window_handle() const;
+    
+    // 因队列已满或没有接收者而丢弃的native事件数量
+    int64_t get_dropped_native_event_count() const;
+    
+    // 合并模式下每帧只发出一次window_moved/window_resized，关闭后逐个发出
+    void set_coalesce_window_events(bool enabled);
+    bool get_coalesce_window_events() const;
+    int get_window_moved_event_count() const;
+    int get_window_resized_event_count() const;
+    
     // 多显示器支持
     int get_monitor_count() const;
     Vector2 get_monitor_size(int monitor_index) const;
     Vector2 get_monitor_position(int monitor_index) const;
     int get_current_monitor() const;
+    // 监视器拓扑缓存：[x, y, width, height] * 监视器数量
+    PackedFloat32Array get_monitor_rects() const;
+    Rect2 get_virtual_desktop_rect() const;
+    float get_monitor_dpi(int monitor_index) const;
     
-    // 鼠标和键盘 - 静态方法
+    // 鼠标和键盘 - 静态方法（读取每帧共享的输入采样）
     static Vector2 get_cursor_position();
     static void set_cursor_position(Vector2 position);
     static int get_mouse_buttons();
     static int get_modifier_keys();
+    
+    // native库功能位（NativeCapability），has_capability只检查请求的功能涉及的函数
+    static int get_capabilities();
+    static bool has_capability(int capabilities);
+    
+    // 启动时间线：脚本用Time.get_ticks_usec()记录的阶段也加入其中，finish之后停止记录
+    static void add_startup_phase(const String& name, int64_t start_ticks_usec, int64_t end_ticks_usec);
+    static void finish_startup_trace();
+    static Dictionary get_startup_timeline();
+    static String get_startup_trace_json();     // Chrome trace-event格式
+    
+    // 输入采样频率（Hz，0为每帧）和带时间戳的采样历史
+    static void set_input_sample_rate(int rate);
+    static int get_input_sample_rate();
+    static void set_input_history_size(int size);
+    static int get_input_history_size();
+    // [time(秒), x, y, buttons, modifiers] * 采样数，从旧到新
+    static PackedFloat64Array get_input_history();
 
 private:
     // Native 库接口
     void _initialize_native();
     void _cleanup_native();
     void _update_from_native();
+    void _mark_dirty(uint32_t flags);
+    void _apply_dirty(uint32_t flags);
+    bool _fit_to_rect(const Rect2& rect);
+    bool _try_attach(bool quiet = false);
+    void _process_attach(double delta);
+    void _finish_attach(bool success);
+    void _process_fit(double delta);
+    void _enter_fit_state(FitState state);
+    void _finish_fit(bool success);
+    void _process_window_drag();
     
     // 回调处理
-    static void _on_files_dropped(const wchar_t* file_paths_w);  // 宽字符版本，转换为UTF-8
+    static void _post_native_event(NativeEvent event);
+    static void _dispatch_native_events();
+    static void _discard_native_events();
+    static UniWindowController* _find_controller(int64_t window_key);
+    void _register_window();
+    void _unregister_window();
+    bool _owns_native_window() const;
+    bool _is_in_main_window() const;
+    void _release_native_window();
+    void _handle_native_event(NativeEvent& event);
+    void _process_pending_drops();
+    void _flush_coalesced_events();
+    void _emit_files_dropped(const PackedStringArray& files);
+    static void _on_files_dropped(const wchar_t* file_paths_w);
     static void _on_window_focus_changed(bool focused);
     static void _on_window_moved(float x, float y);
     static void _on_window_resized(float width, float height);
@@ -1,8 +1,21 @@
 #include "uniwinc_core.h"
+#include "uniwinc_log.h"
+#include "uniwinc_spsc_queue.h"
+#include "uniwinc_startup_trace.h"
 
-#include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/time.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -39,6 +52,36 @@ float UniWinCore::_opacity_threshold = 0.1f;
 bool UniWinCore::_hit_test_enabled = true;
 Color UniWinCore::_key_color = Color(1.0f, 0.0f, 1.0f, 0.0f);
 
+// 窗口状态快照
+WindowStateSnapshot UniWinCore::_window_state;
+std::atomic<uint32_t> UniWinCore::_window_state_dirty(WINDOW_STATE_ALL);
+MonitorTopology UniWinCore::_monitor_topology;
+InputSample UniWinCore::_input_sample;
+bool UniWinCore::_input_sample_dirty = true;
+int UniWinCore::_input_sample_rate = 0;
+std::vector<InputSample> UniWinCore::_input_history;
+int UniWinCore::_input_history_head = 0;
+int UniWinCore::_input_history_count = 0;
+std::atomic<bool> UniWinCore::_monitor_topology_dirty(true);
+
+// 异步命令
+bool UniWinCore::_async_commands = false;
+WindowCommand UniWinCore::_pending_commands[WINDOW_COMMAND_COUNT];
+bool UniWinCore::_has_pending_command[WINDOW_COMMAND_COUNT] = {};
+WindowCommand UniWinCore::_inflight_commands[WINDOW_COMMAND_COUNT];
+int UniWinCore::_inflight_count[WINDOW_COMMAND_COUNT] = {};
+
+// 主线程 -> 工作线程的命令队列，工作线程 -> 主线程的完成队列
+// 工作线程只在Windows上使用；其他平台窗口只能在主线程操作，命令在flush_commands中直接执行
+static UniWinSpscQueue<WindowCommand, 64> g_command_queue;
+static UniWinSpscQueue<WindowCommand, 64> g_completion_queue;
+static std::deque<WindowCommand> g_main_thread_completions;  // 主线程执行的命令的完成通知
+static std::atomic<int64_t> g_native_window_handle{0};
+static std::thread g_command_thread;
+static std::atomic<bool> g_command_thread_stop(false);
+static std::mutex g_command_mutex;  // 只用于休眠/唤醒，不保护队列
+static std::condition_variable g_command_cv;
+
 // Native 函数指针定义
 typedef bool (*IsActiveFunc)();
 typedef bool (*AttachMyWindowFunc)();
@@ -101,69 +144,165 @@ typedef bool (*RegisterWindowResizedCallbackFunc)(FloatFloatCallbackFunc);
 typedef bool (*RegisterMonitorChangedCallbackFunc)(IntCallbackFunc);
 
 // 文件对话框函数指针
-typedef bool (*OpenFilePanelFunc)(void *, char *, int);
-typedef bool (*SaveFilePanelFunc)(void *, char *, int);
+typedef bool (*FilePanelFunc)(const NativePanelSettings *, char16_t *, uint32_t);
+typedef FilePanelFunc OpenFilePanelFunc;
+typedef FilePanelFunc SaveFilePanelFunc;
+
+// 按需解析的native符号：第一次使用时查找并缓存地址，库重新加载或卸载后重新查找
+// 可在任意线程使用，并发的首次解析只会重复查找同一个符号
+static std::atomic<void *> g_symbol_library(nullptr);
+static std::atomic<uint32_t> g_library_generation(1);
+
+class NativeSymbol
+{
+private:
+    const char *_name;
+    mutable std::atomic<void *> _address;
+    mutable std::atomic<uint32_t> _generation;  // 解析时的库版本，0为尚未解析
+
+public:
+    constexpr explicit NativeSymbol(const char *name) : _name(name), _address(nullptr), _generation(0) {}
+
+    void *resolve() const
+    {
+        uint32_t generation = g_library_generation.load(std::memory_order_acquire);
+        if (_generation.load(std::memory_order_acquire) != generation)
+        {
+            void *library = g_symbol_library.load(std::memory_order_acquire);
+            _address.store(library ? (void *)GET_PROC_ADDRESS(library, _name) : nullptr, std::memory_order_relaxed);
+            _generation.store(generation, std::memory_order_release);
+        }
+        return _address.load(std::memory_order_relaxed);
+    }
+};
+
+// 可以像原来的函数指针一样判空和调用
+template <typename F>
+class NativeFunction : public NativeSymbol
+{
+public:
+    constexpr explicit NativeFunction(const char *name) : NativeSymbol(name) {}
+    operator F() const { return (F)resolve(); }
+};
 
 // 函数指针实例
-static IsActiveFunc native_is_active = nullptr;
-static AttachMyWindowFunc native_attach_window = nullptr;
-static AttachMyActiveWindowFunc native_attach_active_window = nullptr;
-static AttachMyOwnerWindowFunc native_attach_owner_window = nullptr;
-static DetachWindowFunc native_detach_window = nullptr;
-static IsTransparentFunc native_is_transparent = nullptr;
-static IsBorderlessFunc native_is_borderless = nullptr;
-static IsTopmostFunc native_is_topmost = nullptr;
-static IsBottommostFunc native_is_bottommost = nullptr;
-static IsMaximizedFunc native_is_maximized = nullptr;
-static IsMinimizedFunc native_is_minimized = nullptr;
-static IsZoomedFunc native_is_zoomed = nullptr;
-static SetTransparentFunc native_set_transparent = nullptr;
-static SetBorderlessFunc native_set_borderless = nullptr;
-static SetTopmostFunc native_set_topmost = nullptr;
-static SetBottommostFunc native_set_bottommost = nullptr;
-static SetAlphaValueFunc native_set_alpha_value = nullptr;
-static SetClickThroughFunc native_set_clickthrough = nullptr;
-static SetZoomedFunc native_set_zoomed = nullptr;
-static SetPositionFunc native_set_position = nullptr;
-static GetPositionFunc native_get_position = nullptr;
-static SetSizeFunc native_set_size = nullptr;
-static GetSizeFunc native_get_size = nullptr;
-static GetClientSizeFunc native_get_client_size = nullptr;
-static GetMonitorCountFunc native_get_monitor_count = nullptr;
-static GetMonitorRectangleFunc native_get_monitor_rectangle = nullptr;
-static GetCurrentMonitorFunc native_get_current_monitor = nullptr;
-static SetAllowDropFunc native_set_allow_drop = nullptr;
-static GetCursorPositionFunc native_get_cursor_position = nullptr;
-static SetCursorPositionFunc native_set_cursor_position = nullptr;
-static GetMouseButtonsFunc native_get_mouse_buttons = nullptr;
-static GetModifierKeysFunc native_get_modifier_keys = nullptr;
-static MinimizeWindowFunc native_minimize_window = nullptr;
-static MaximizeWindowFunc native_maximize_window = nullptr;
-static RestoreWindowFunc native_restore_window = nullptr;
-static FitToMonitorFunc native_fit_to_monitor = nullptr;
+static NativeFunction<IsActiveFunc> native_is_active("IsActive");
+static NativeFunction<AttachMyWindowFunc> native_attach_window("AttachMyWindow");
+static NativeFunction<AttachMyActiveWindowFunc> native_attach_active_window("AttachMyActiveWindow");
+static NativeFunction<AttachMyOwnerWindowFunc> native_attach_owner_window("AttachMyOwnerWindow");
+static NativeFunction<DetachWindowFunc> native_detach_window("DetachWindow");
+static NativeFunction<IsTransparentFunc> native_is_transparent("IsTransparent");
+static NativeFunction<IsBorderlessFunc> native_is_borderless("IsBorderless");
+static NativeFunction<IsTopmostFunc> native_is_topmost("IsTopmost");
+static NativeFunction<IsBottommostFunc> native_is_bottommost("IsBottommost");
+static NativeFunction<IsMaximizedFunc> native_is_maximized("IsMaximized");
+static NativeFunction<IsMinimizedFunc> native_is_minimized("IsMinimized");
+static NativeFunction<IsZoomedFunc> native_is_zoomed("IsMaximized");
+static NativeFunction<SetTransparentFunc> native_set_transparent("SetTransparent");
+static NativeFunction<SetBorderlessFunc> native_set_borderless("SetBorderless");
+static NativeFunction<SetTopmostFunc> native_set_topmost("SetTopmost");
+static NativeFunction<SetBottommostFunc> native_set_bottommost("SetBottommost");
+static NativeFunction<SetAlphaValueFunc> native_set_alpha_value("SetAlphaValue");
+static NativeFunction<SetClickThroughFunc> native_set_clickthrough("SetClickThrough");
+static NativeFunction<SetZoomedFunc> native_set_zoomed("SetMaximized");
+static NativeFunction<SetPositionFunc> native_set_position("SetPosition");
+static NativeFunction<GetPositionFunc> native_get_position("GetPosition");
+static NativeFunction<SetSizeFunc> native_set_size("SetSize");
+static NativeFunction<GetSizeFunc> native_get_size("GetSize");
+static NativeFunction<GetClientSizeFunc> native_get_client_size("GetClientSize");
+static NativeFunction<GetMonitorCountFunc> native_get_monitor_count("GetMonitorCount");
+static NativeFunction<GetMonitorRectangleFunc> native_get_monitor_rectangle("GetMonitorRectangle");
+static NativeFunction<GetCurrentMonitorFunc> native_get_current_monitor("GetCurrentMonitor");
+static NativeFunction<SetAllowDropFunc> native_set_allow_drop("SetAllowDrop");
+static NativeFunction<GetCursorPositionFunc> native_get_cursor_position("GetCursorPosition");
+static NativeFunction<SetCursorPositionFunc> native_set_cursor_position("SetCursorPosition");
+static NativeFunction<GetMouseButtonsFunc> native_get_mouse_buttons("GetMouseButtons");
+static NativeFunction<GetModifierKeysFunc> native_get_modifier_keys("GetModifierKeys");
+static NativeFunction<MinimizeWindowFunc> native_minimize_window("MinimizeWindow");
+static NativeFunction<MaximizeWindowFunc> native_maximize_window("MaximizeWindow");
+static NativeFunction<RestoreWindowFunc> native_restore_window("RestoreWindow");
+static NativeFunction<FitToMonitorFunc> native_fit_to_monitor("FitToMonitor");
 
 // Unity兼容的扩展函数指针实例
-static SetTransparentTypeFunc native_set_transparent_type = nullptr;
-static GetTransparentTypeFunc native_get_transparent_type = nullptr;
-static SetKeyColorFunc native_set_key_color = nullptr;
-static GetKeyColorFunc native_get_key_color = nullptr;
-static SetHitTestTypeFunc native_set_hit_test_type = nullptr;
-static GetHitTestTypeFunc native_get_hit_test_type = nullptr;
-static SetOpacityThresholdFunc native_set_opacity_threshold = nullptr;
-static GetOpacityThresholdFunc native_get_opacity_threshold = nullptr;
-static SetHitTestEnabledFunc native_set_hit_test_enabled = nullptr;
-static GetHitTestEnabledFunc native_get_hit_test_enabled = nullptr;
+static NativeFunction<SetTransparentTypeFunc> native_set_transparent_type("SetTransparentType");
+static NativeFunction<GetTransparentTypeFunc> native_get_transparent_type("GetTransparentType");
+static NativeFunction<SetKeyColorFunc> native_set_key_color("SetKeyColor");
+static NativeFunction<GetKeyColorFunc> native_get_key_color("GetKeyColor");
+static NativeFunction<SetHitTestTypeFunc> native_set_hit_test_type("SetHitTestType");
+static NativeFunction<GetHitTestTypeFunc> native_get_hit_test_type("GetHitTestType");
+static NativeFunction<SetOpacityThresholdFunc> native_set_opacity_threshold("SetOpacityThreshold");
+static NativeFunction<GetOpacityThresholdFunc> native_get_opacity_threshold("GetOpacityThreshold");
+static NativeFunction<SetHitTestEnabledFunc> native_set_hit_test_enabled("SetHitTestEnabled");
+static NativeFunction<GetHitTestEnabledFunc> native_get_hit_test_enabled("GetHitTestEnabled");
 
 // 回调函数指针实例
-static RegisterDropFilesCallbackFunc native_register_drop_files_callback = nullptr;
-static RegisterWindowStyleChangedCallbackFunc native_register_focus_changed_callback = nullptr;
-static RegisterWindowMovedCallbackFunc native_register_window_moved_callback = nullptr;
-static RegisterWindowResizedCallbackFunc native_register_window_resized_callback = nullptr;
-static RegisterMonitorChangedCallbackFunc native_register_monitor_changed_callback = nullptr;
+static NativeFunction<RegisterDropFilesCallbackFunc> native_register_drop_files_callback("RegisterDropFilesCallback");
+static NativeFunction<RegisterWindowStyleChangedCallbackFunc> native_register_focus_changed_callback("RegisterWindowStyleChangedCallback");
+static NativeFunction<RegisterWindowMovedCallbackFunc> native_register_window_moved_callback("RegisterWindowMovedCallback");
+static NativeFunction<RegisterWindowResizedCallbackFunc> native_register_window_resized_callback("RegisterWindowResizedCallback");
+static NativeFunction<RegisterMonitorChangedCallbackFunc> native_register_monitor_changed_callback("RegisterMonitorChangedCallback");
 
 // 文件对话框函数指针实例
-static OpenFilePanelFunc native_open_file_panel = nullptr;
-static SaveFilePanelFunc native_save_file_panel = nullptr;
+static NativeFunction<OpenFilePanelFunc> native_open_file_panel("OpenFilePanel");
+static NativeFunction<SaveFilePanelFunc> native_save_file_panel("SaveFilePanel");
+
+// 每个功能位需要的native函数（全部可用时该功能可用）
+struct CapabilityGroup
+{
+    int capability;
+    const NativeSymbol *symbols[6];  // 以nullptr结束
+};
+
+static const CapabilityGroup g_capability_groups[] = {
+    { CAPABILITY_WINDOW_ATTACH, { &native_attach_window, &native_detach_window, &native_is_active } },
+    { CAPABILITY_TRANSPARENCY, { &native_set_transparent, &native_is_transparent, &native_set_alpha_value } },
+    { CAPABILITY_WINDOW_STYLE, { &native_set_borderless, &native_set_topmost, &native_set_bottommost } },
+    { CAPABILITY_CLICK_THROUGH, { &native_set_clickthrough } },
+    { CAPABILITY_WINDOW_RECT, { &native_get_position, &native_set_position, &native_get_size, &native_set_size } },
+    { CAPABILITY_MAXIMIZE, { &native_set_zoomed, &native_is_zoomed } },
+    { CAPABILITY_MONITORS, { &native_get_monitor_count, &native_get_monitor_rectangle, &native_get_current_monitor } },
+    { CAPABILITY_FIT_TO_MONITOR, { &native_fit_to_monitor } },
+    { CAPABILITY_CURSOR, { &native_get_cursor_position, &native_set_cursor_position } },
+    { CAPABILITY_MOUSE_KEYBOARD, { &native_get_mouse_buttons, &native_get_modifier_keys } },
+    { CAPABILITY_DROP_FILES, { &native_set_allow_drop, &native_register_drop_files_callback } },
+    { CAPABILITY_FILE_DIALOGS, { &native_open_file_panel, &native_save_file_panel } },
+    { CAPABILITY_WINDOW_EVENTS, { &native_register_window_moved_callback, &native_register_window_resized_callback,
+                                 &native_register_focus_changed_callback, &native_register_monitor_changed_callback } },
+    { CAPABILITY_KEY_COLOR, { &native_set_transparent_type, &native_set_key_color } },
+};
+
+bool UniWinCore::has_capability(int capabilities)
+{
+    // 只解析请求的功能位涉及的符号
+    for (const CapabilityGroup &group : g_capability_groups)
+    {
+        if ((capabilities & group.capability) == 0)
+        {
+            continue;
+        }
+        for (const NativeSymbol *symbol : group.symbols)
+        {
+            if (symbol && !symbol->resolve())
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int UniWinCore::get_capabilities()
+{
+    int result = 0;
+    for (const CapabilityGroup &group : g_capability_groups)
+    {
+        if (has_capability(group.capability))
+        {
+            result |= group.capability;
+        }
+    }
+    return result;
+}
 
 bool UniWinCore::initialize()
 {
@@ -171,22 +310,24 @@ bool UniWinCore::initialize()
     {
         return true;
     }
+    UNIWINC_TRACE_SCOPE("UniWinCore::initialize");
 
     if (!load_native_library())
     {
-        UtilityFunctions::print("Failed to load native library");
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_CORE, "Failed to load native library");
         return false;
     }
 
     if (!load_function_pointers())
     {
-        UtilityFunctions::print("Failed to load function pointers");
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_CORE, "Failed to load function pointers");
         unload_native_library();
         return false;
     }
 
     _is_initialized = true;
-    UtilityFunctions::print("UniWinCore initialized successfully");
+    invalidate_monitor_topology();
+    UNIWINC_LOG_INFO(UniWinLog::CATEGORY_CORE, "UniWinCore initialized successfully");
     return true;
 }
 
@@ -194,14 +335,17 @@ void UniWinCore::cleanup()
 {
     if (_is_initialized)
     {
+        // 卸载库之前必须让工作线程执行完剩余命令
+        set_async_commands(false);
         unload_native_library();
         _is_initialized = false;
-        UtilityFunctions::print("UniWinCore cleaned up");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "UniWinCore cleaned up");
     }
 }
 
 bool UniWinCore::load_native_library()
 {
+    UNIWINC_TRACE_SCOPE("UniWinCore::load_native_library");
     String library_path;
 
 #ifdef _WIN32
@@ -215,12 +359,12 @@ bool UniWinCore::load_native_library()
     // 转换为绝对路径
     String abs_path = ProjectSettings::get_singleton()->globalize_path(library_path);
 
-    UtilityFunctions::print("Attempting to load native library: " + abs_path);
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "Attempting to load native library: " + abs_path);
 
     // 检查文件是否存在
     if (!FileAccess::file_exists(abs_path))
     {
-        UtilityFunctions::print("Native library file does not exist: " + abs_path);
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_CORE, "Native library file does not exist: " + abs_path);
 
         // 尝试备用路径
         String fallback_path = "./LibUniWinC" LIBRARY_EXTENSION;
@@ -228,32 +372,32 @@ bool UniWinCore::load_native_library()
 
         if (!FileAccess::file_exists(abs_path))
         {
-            UtilityFunctions::print("Fallback path also does not exist: " + abs_path);
+            UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_CORE, "Fallback path also does not exist: " + abs_path);
             return false;
         }
 
-        UtilityFunctions::print("Using fallback path: " + abs_path);
+        UNIWINC_LOG_INFO(UniWinLog::CATEGORY_CORE, "Using fallback path: " + abs_path);
     }
 
     _library_handle = LOAD_LIBRARY(abs_path.utf8().get_data());
 
     if (_library_handle)
     {
-        UtilityFunctions::print("Successfully loaded native library");
+        UNIWINC_LOG_INFO(UniWinLog::CATEGORY_CORE, "Successfully loaded native library");
         return true;
     }
     else
     {
-        UtilityFunctions::print("Failed to load native library");
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_CORE, "Failed to load native library");
 
 #ifdef _WIN32
         DWORD error = GetLastError();
-        UtilityFunctions::print("Windows error code: " + String::num_int64(error));
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_CORE, "Windows error code: " + String::num_int64(error));
 #else
         const char *error = dlerror();
         if (error)
         {
-            UtilityFunctions::print("dlerror: " + String(error));
+            UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_CORE, "dlerror: " + String(error));
         }
 #endif
         return false;
@@ -264,6 +408,9 @@ void UniWinCore::unload_native_library()
 {
     if (_library_handle)
     {
+        // 先让已解析的符号失效，之后的调用看到的都是空指针
+        g_symbol_library.store(nullptr, std::memory_order_release);
+        g_library_generation.fetch_add(1, std::memory_order_acq_rel);
         FREE_LIBRARY(_library_handle);
         _library_handle = nullptr;
     }
@@ -275,119 +422,47 @@ bool UniWinCore::load_function_pointers()
     {
         return false;
     }
+    UNIWINC_TRACE_SCOPE("UniWinCore::load_function_pointers");
+
+    // 函数指针在第一次调用时才解析，这里只切换符号表使用的库并检查附加窗口必需的函数
+    g_symbol_library.store(_library_handle, std::memory_order_release);
+    g_library_generation.fetch_add(1, std::memory_order_acq_rel);
 
-    // 加载基础函数指针
-    native_is_active = (IsActiveFunc)GET_PROC_ADDRESS(_library_handle, "IsActive");
-    native_attach_window = (AttachMyWindowFunc)GET_PROC_ADDRESS(_library_handle, "AttachMyWindow");
-    native_attach_active_window = (AttachMyActiveWindowFunc)GET_PROC_ADDRESS(_library_handle, "AttachMyActiveWindow");
-    native_attach_owner_window = (AttachMyOwnerWindowFunc)GET_PROC_ADDRESS(_library_handle, "AttachMyOwnerWindow");
-    native_detach_window = (DetachWindowFunc)GET_PROC_ADDRESS(_library_handle, "DetachWindow");
-
-    // 状态查询函数
-    native_is_transparent = (IsTransparentFunc)GET_PROC_ADDRESS(_library_handle, "IsTransparent");
-    native_is_borderless = (IsBorderlessFunc)GET_PROC_ADDRESS(_library_handle, "IsBorderless");
-    native_is_topmost = (IsTopmostFunc)GET_PROC_ADDRESS(_library_handle, "IsTopmost");
-    native_is_bottommost = (IsBottommostFunc)GET_PROC_ADDRESS(_library_handle, "IsBottommost");
-    native_is_maximized = (IsMaximizedFunc)GET_PROC_ADDRESS(_library_handle, "IsMaximized");
-    native_is_minimized = (IsMinimizedFunc)GET_PROC_ADDRESS(_library_handle, "IsMinimized");
-    native_is_zoomed = (IsZoomedFunc)GET_PROC_ADDRESS(_library_handle, "IsMaximized"); // Unity兼容
-
-    // 基础设置函数
-    native_set_transparent = (SetTransparentFunc)GET_PROC_ADDRESS(_library_handle, "SetTransparent");
-    native_set_borderless = (SetBorderlessFunc)GET_PROC_ADDRESS(_library_handle, "SetBorderless");
-    native_set_topmost = (SetTopmostFunc)GET_PROC_ADDRESS(_library_handle, "SetTopmost");
-    native_set_bottommost = (SetBottommostFunc)GET_PROC_ADDRESS(_library_handle, "SetBottommost");
-    native_set_alpha_value = (SetAlphaValueFunc)GET_PROC_ADDRESS(_library_handle, "SetAlphaValue");
-    native_set_clickthrough = (SetClickThroughFunc)GET_PROC_ADDRESS(_library_handle, "SetClickThrough");
-    native_set_zoomed = (SetZoomedFunc)GET_PROC_ADDRESS(_library_handle, "SetMaximized"); // Unity兼容
-
-    // 位置和大小函数
-    native_set_position = (SetPositionFunc)GET_PROC_ADDRESS(_library_handle, "SetPosition");
-    native_get_position = (GetPositionFunc)GET_PROC_ADDRESS(_library_handle, "GetPosition");
-    native_set_size = (SetSizeFunc)GET_PROC_ADDRESS(_library_handle, "SetSize");
-    native_get_size = (GetSizeFunc)GET_PROC_ADDRESS(_library_handle, "GetSize");
-    native_get_client_size = (GetClientSizeFunc)GET_PROC_ADDRESS(_library_handle, "GetClientSize");
-
-    // 监视器相关函数
-    native_get_monitor_count = (GetMonitorCountFunc)GET_PROC_ADDRESS(_library_handle, "GetMonitorCount");
-    native_get_monitor_rectangle = (GetMonitorRectangleFunc)GET_PROC_ADDRESS(_library_handle, "GetMonitorRectangle");
-    native_get_current_monitor = (GetCurrentMonitorFunc)GET_PROC_ADDRESS(_library_handle, "GetCurrentMonitor");
-    native_fit_to_monitor = (FitToMonitorFunc)GET_PROC_ADDRESS(_library_handle, "FitToMonitor");
-
-    // 文件拖拽和鼠标键盘
-    native_set_allow_drop = (SetAllowDropFunc)GET_PROC_ADDRESS(_library_handle, "SetAllowDrop");
-    native_get_cursor_position = (GetCursorPositionFunc)GET_PROC_ADDRESS(_library_handle, "GetCursorPosition");
-    native_set_cursor_position = (SetCursorPositionFunc)GET_PROC_ADDRESS(_library_handle, "SetCursorPosition");
-    native_get_mouse_buttons = (GetMouseButtonsFunc)GET_PROC_ADDRESS(_library_handle, "GetMouseButtons");
-    native_get_modifier_keys = (GetModifierKeysFunc)GET_PROC_ADDRESS(_library_handle, "GetModifierKeys");
-
-    // 窗口控制函数
-    native_minimize_window = (MinimizeWindowFunc)GET_PROC_ADDRESS(_library_handle, "MinimizeWindow");
-    native_maximize_window = (MaximizeWindowFunc)GET_PROC_ADDRESS(_library_handle, "MaximizeWindow");
-    native_restore_window = (RestoreWindowFunc)GET_PROC_ADDRESS(_library_handle, "RestoreWindow");
-
-    // Unity兼容的扩展函数（可能不存在于native库中，需要在C++层模拟）
-    native_set_transparent_type = (SetTransparentTypeFunc)GET_PROC_ADDRESS(_library_handle, "SetTransparentType");
-    native_get_transparent_type = (GetTransparentTypeFunc)GET_PROC_ADDRESS(_library_handle, "GetTransparentType");
-    native_set_key_color = (SetKeyColorFunc)GET_PROC_ADDRESS(_library_handle, "SetKeyColor");
-    native_get_key_color = (GetKeyColorFunc)GET_PROC_ADDRESS(_library_handle, "GetKeyColor");
-    native_set_hit_test_type = (SetHitTestTypeFunc)GET_PROC_ADDRESS(_library_handle, "SetHitTestType");
-    native_get_hit_test_type = (GetHitTestTypeFunc)GET_PROC_ADDRESS(_library_handle, "GetHitTestType");
-    native_set_opacity_threshold = (SetOpacityThresholdFunc)GET_PROC_ADDRESS(_library_handle, "SetOpacityThreshold");
-    native_get_opacity_threshold = (GetOpacityThresholdFunc)GET_PROC_ADDRESS(_library_handle, "GetOpacityThreshold");
-    native_set_hit_test_enabled = (SetHitTestEnabledFunc)GET_PROC_ADDRESS(_library_handle, "SetHitTestEnabled");
-    native_get_hit_test_enabled = (GetHitTestEnabledFunc)GET_PROC_ADDRESS(_library_handle, "GetHitTestEnabled");
-
-    // 回调注册函数
-    native_register_drop_files_callback = (RegisterDropFilesCallbackFunc)GET_PROC_ADDRESS(_library_handle, "RegisterDropFilesCallback");
-    native_register_focus_changed_callback = (RegisterWindowStyleChangedCallbackFunc)GET_PROC_ADDRESS(_library_handle, "RegisterWindowStyleChangedCallback");
-    native_register_window_moved_callback = (RegisterWindowMovedCallbackFunc)GET_PROC_ADDRESS(_library_handle, "RegisterWindowMovedCallback");
-    native_register_window_resized_callback = (RegisterWindowResizedCallbackFunc)GET_PROC_ADDRESS(_library_handle, "RegisterWindowResizedCallback");
-    native_register_monitor_changed_callback = (RegisterMonitorChangedCallbackFunc)GET_PROC_ADDRESS(_library_handle, "RegisterMonitorChangedCallback");
-
-    // 文件对话框函数
-    native_open_file_panel = (OpenFilePanelFunc)GET_PROC_ADDRESS(_library_handle, "OpenFilePanel");
-    native_save_file_panel = (SaveFilePanelFunc)GET_PROC_ADDRESS(_library_handle, "SaveFilePanel");
-
-    // 检查关键函数是否加载成功
-    bool core_functions_loaded = native_is_active && native_attach_window && native_detach_window;
-
-    // 检查drop files相关函数是否加载成功
-    bool drop_files_loaded = native_set_allow_drop && native_register_drop_files_callback;
-
-    // 检查监视器相关函数是否加载成功
-    bool monitor_functions_loaded = native_get_monitor_count && native_get_monitor_rectangle;
-    bool fit_monitor_available = native_fit_to_monitor != nullptr;
-
-    UtilityFunctions::print("Function loading status:");
-    UtilityFunctions::print("  Core functions: " + String(core_functions_loaded ? "OK" : "FAILED"));
-    UtilityFunctions::print("  Drop files functions: " + String(drop_files_loaded ? "OK" : "FAILED"));
-    UtilityFunctions::print("    - SetAllowDrop: " + String(native_set_allow_drop ? "OK" : "MISSING"));
-    UtilityFunctions::print("    - RegisterDropFilesCallback (wide): " + String(native_register_drop_files_callback ? "OK" : "MISSING"));
-    UtilityFunctions::print("  Monitor functions: " + String(monitor_functions_loaded ? "OK" : "FAILED"));
-    UtilityFunctions::print("    - GetMonitorCount: " + String(native_get_monitor_count ? "OK" : "MISSING"));
-    UtilityFunctions::print("    - GetMonitorRectangle: " + String(native_get_monitor_rectangle ? "OK" : "MISSING"));
-    UtilityFunctions::print("    - FitToMonitor: " + String(fit_monitor_available ? "OK" : "MISSING"));
-    UtilityFunctions::print("  Window control functions:");
-    UtilityFunctions::print("    - SetMaximized: " + String(native_set_zoomed ? "OK" : "MISSING"));
-    UtilityFunctions::print("    - IsMaximized: " + String(native_is_zoomed ? "OK" : "MISSING"));
+    bool core_functions_loaded = has_capability(CAPABILITY_WINDOW_ATTACH);
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "Core functions: " + String(core_functions_loaded ? "OK" : "FAILED"));
 
     return core_functions_loaded;
 }
 
 // 实现所有接口函数
-bool UniWinCore::attach_window()
+bool UniWinCore::attach_window(bool quiet)
 {
+    UNIWINC_TRACE_SCOPE("UniWinCore::attach_window");
+    invalidate_window_state();
     if (!native_attach_window)
     {
-        UtilityFunctions::print("Native attach_window function not available");
+        if (quiet)
+        {
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "Native attach_window function not available");
+        }
+        else
+        {
+            UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_WINDOW, "Native attach_window function not available");
+        }
         return false;
     }
 
     bool result = native_attach_window();
     if (!result)
     {
-        UtilityFunctions::print("AttachMyWindow failed, trying alternative methods...");
+        if (quiet)
+        {
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "AttachMyWindow failed, trying alternative methods...");
+        }
+        else
+        {
+            UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_WINDOW, "AttachMyWindow failed, trying alternative methods...");
+        }
 
         // 尝试活动窗口附加
         if (native_attach_active_window)
@@ -395,7 +470,7 @@ bool UniWinCore::attach_window()
             result = native_attach_active_window();
             if (result)
             {
-                UtilityFunctions::print("Successfully attached to active window");
+                UNIWINC_LOG_INFO(UniWinLog::CATEGORY_WINDOW, "Successfully attached to active window");
                 return true;
             }
         }
@@ -406,16 +481,23 @@ bool UniWinCore::attach_window()
             result = native_attach_owner_window();
             if (result)
             {
-                UtilityFunctions::print("Successfully attached to owner window");
+                UNIWINC_LOG_INFO(UniWinLog::CATEGORY_WINDOW, "Successfully attached to owner window");
                 return true;
             }
         }
 
-        UtilityFunctions::print("All attach methods failed");
+        if (quiet)
+        {
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "All attach methods failed");
+        }
+        else
+        {
+            UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_WINDOW, "All attach methods failed");
+        }
     }
     else
     {
-        UtilityFunctions::print("Successfully attached to window using default method");
+        UNIWINC_LOG_INFO(UniWinLog::CATEGORY_WINDOW, "Successfully attached to window using default method");
     }
 
     return result;
@@ -427,11 +509,435 @@ void UniWinCore::detach_window()
     {
         native_detach_window();
     }
+    invalidate_window_state();
+}
+
+const WindowStateSnapshot &UniWinCore::get_window_state(uint32_t fields)
+{
+    // 同一帧内且没有回调通知变化的字段直接返回缓存
+    uint64_t frame = Engine::get_singleton()->get_process_frames();
+    if (_window_state.frame != frame)
+    {
+        _window_state.frame = frame;
+        _window_state.valid = 0;
+    }
+    // 只取走本次读取的字段的失效标记，其余字段留到被读取时再刷新
+    uint32_t dirty = _window_state_dirty.fetch_and(~fields, std::memory_order_acq_rel);
+    uint32_t stale = (dirty | ~_window_state.valid) & fields;
+    if (stale != 0)
+    {
+        refresh_window_state(stale);
+        _window_state.valid |= fields;
+    }
+    
+    // 尚未执行完的异步命令：返回请求的目标值，保证读写一致
+    if (_async_commands)
+    {
+        if (const WindowCommand *command = latest_command(WINDOW_COMMAND_SET_POSITION))
+        {
+            _window_state.x = command->x;
+            _window_state.y = command->y;
+        }
+        if (const WindowCommand *command = latest_command(WINDOW_COMMAND_SET_SIZE))
+        {
+            _window_state.width = command->x;
+            _window_state.height = command->y;
+        }
+        if (const WindowCommand *command = latest_command(WINDOW_COMMAND_SET_RECT))
+        {
+            _window_state.x = command->x;
+            _window_state.y = command->y;
+            _window_state.width = command->width;
+            _window_state.height = command->height;
+            if (command->value != 0)
+            {
+                _window_state.zoomed = false;
+                _window_state.maximized = false;
+            }
+        }
+        if (const WindowCommand *command = latest_command(WINDOW_COMMAND_SET_ZOOMED))
+        {
+            _window_state.zoomed = command->value != 0;
+            _window_state.maximized = command->value != 0;
+        }
+    }
+    return _window_state;
+}
+
+void UniWinCore::invalidate_window_state(uint32_t fields)
+{
+    // 可能从native回调线程调用，只设置标志
+    _window_state_dirty.fetch_or(fields, std::memory_order_acq_rel);
+}
+
+void UniWinCore::refresh_window_state(uint32_t fields)
+{
+    WindowStateSnapshot &state = _window_state;
+    if (fields & WINDOW_STATE_ACTIVE)
+    {
+        state.active = native_is_active ? native_is_active() : false;
+    }
+    if (fields & WINDOW_STATE_MAXIMIZED)
+    {
+        state.maximized = native_is_maximized ? native_is_maximized() : false;
+    }
+    if (fields & WINDOW_STATE_MINIMIZED)
+    {
+        state.minimized = native_is_minimized ? native_is_minimized() : false;
+    }
+    if (fields & WINDOW_STATE_ZOOMED)
+    {
+        state.zoomed = native_is_zoomed ? native_is_zoomed() : false;
+    }
+    if ((fields & WINDOW_STATE_POSITION) && native_get_position)
+    {
+        native_get_position(&state.x, &state.y);
+    }
+    if ((fields & WINDOW_STATE_SIZE) && native_get_size)
+    {
+        native_get_size(&state.width, &state.height);
+    }
+}
+
+void UniWinCore::set_async_commands(bool enabled)
+{
+    if (enabled == _async_commands)
+    {
+        return;
+    }
+    if (enabled)
+    {
+#ifdef _WIN32
+        start_command_thread();
+#endif
+        _async_commands = true;
+    }
+    else
+    {
+        // 先提交本帧积攒的命令，再等待工作线程执行完毕
+        flush_commands();
+        stop_command_thread();
+        _async_commands = false;
+    }
+    invalidate_window_state();
+}
+
+bool UniWinCore::get_async_commands()
+{
+    return _async_commands;
+}
+
+const WindowCommand *UniWinCore::latest_command(int type)
+{
+    if (_has_pending_command[type])
+    {
+        return &_pending_commands[type];
+    }
+    if (_inflight_count[type] > 0)
+    {
+        return &_inflight_commands[type];
+    }
+    return nullptr;
+}
+
+void UniWinCore::post_command(const WindowCommand &command)
+{
+    if (command.type == WINDOW_COMMAND_SET_RECT)
+    {
+        // 整体矩形覆盖本帧之前的大小和位置命令
+        _has_pending_command[WINDOW_COMMAND_SET_SIZE] = false;
+        _has_pending_command[WINDOW_COMMAND_SET_POSITION] = false;
+
+        // 槽位顺序中最大化在矩形之后，待执行的解除最大化并入矩形命令先执行，否则还原会丢弃新矩形
+        bool unzoom = command.value != 0 ||
+                      (_has_pending_command[WINDOW_COMMAND_SET_RECT] && _pending_commands[WINDOW_COMMAND_SET_RECT].value != 0);
+        if (_has_pending_command[WINDOW_COMMAND_SET_ZOOMED] && _pending_commands[WINDOW_COMMAND_SET_ZOOMED].value == 0)
+        {
+            _has_pending_command[WINDOW_COMMAND_SET_ZOOMED] = false;
+            unzoom = true;
+        }
+        WindowCommand rect = command;
+        rect.value = unzoom ? 1 : 0;
+        _pending_commands[WINDOW_COMMAND_SET_RECT] = rect;
+        _has_pending_command[WINDOW_COMMAND_SET_RECT] = true;
+        invalidate_window_state();
+        return;
+    }
+    else if (_has_pending_command[WINDOW_COMMAND_SET_RECT] &&
+             (command.type == WINDOW_COMMAND_SET_SIZE || command.type == WINDOW_COMMAND_SET_POSITION))
+    {
+        // 之后的大小或位置并入待执行的矩形命令，保持一次操作
+        WindowCommand &rect = _pending_commands[WINDOW_COMMAND_SET_RECT];
+        if (command.type == WINDOW_COMMAND_SET_SIZE)
+        {
+            rect.width = command.x;
+            rect.height = command.y;
+        }
+        else
+        {
+            rect.x = command.x;
+            rect.y = command.y;
+        }
+        invalidate_window_state();
+        return;
+    }
+
+    // 同类命令覆盖，本帧只执行最后一个
+    _pending_commands[command.type] = command;
+    _has_pending_command[command.type] = true;
+    invalidate_window_state();
+}
+
+void UniWinCore::flush_commands()
+{
+    bool posted = false;
+    bool use_thread = g_command_thread.joinable() && g_native_window_handle.load(std::memory_order_acquire) != 0;
+    for (int i = 0; i < WINDOW_COMMAND_COUNT; i++)
+    {
+        if (!_has_pending_command[i])
+        {
+            continue;
+        }
+        const WindowCommand &command = _pending_commands[i];
+        if (use_thread)
+        {
+            // 队列满时保留在槽位中下一帧再投递，之后的槽位也一起等待以保持执行顺序；
+            // 不在主线程同步执行，避免与工作线程同时操作窗口
+            if (!g_command_queue.push(command))
+            {
+                UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "Window command queue full, deferring to next frame");
+                break;
+            }
+            posted = true;
+        }
+        else
+        {
+            // 主线程执行合并后的命令（在_process中调用）
+            execute_command(command);
+            invalidate_window_state();
+            g_main_thread_completions.push_back(command);
+        }
+        _has_pending_command[i] = false;
+        _inflight_commands[i] = command;
+        _inflight_count[i]++;
+    }
+    if (posted)
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_command_mutex);
+        }
+        g_command_cv.notify_one();
+    }
+}
+
+bool UniWinCore::pop_completed_command(WindowCommand *command)
+{
+    WindowCommand completed;
+    if (!g_completion_queue.pop(completed))
+    {
+        if (g_main_thread_completions.empty())
+        {
+            return false;
+        }
+        completed = g_main_thread_completions.front();
+        g_main_thread_completions.pop_front();
+    }
+    if (_inflight_count[completed.type] > 0)
+    {
+        _inflight_count[completed.type]--;
+    }
+    invalidate_window_state();
+    if (command)
+    {
+        *command = completed;
+    }
+    return true;
+}
+
+void UniWinCore::start_command_thread()
+{
+    g_command_thread_stop.store(false, std::memory_order_release);
+    g_command_thread = std::thread(&UniWinCore::command_thread_main);
+}
+
+void UniWinCore::stop_command_thread()
+{
+    if (!g_command_thread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_command_mutex);
+        g_command_thread_stop.store(true, std::memory_order_release);
+    }
+    g_command_cv.notify_one();
+    // 工作线程只调用不等待窗口线程的Win32接口，主线程在这里等待不会互相阻塞
+    g_command_thread.join();
+
+    // 工作线程退出前已执行完所有命令，丢弃未取走的完成通知
+    WindowCommand completed;
+    while (g_completion_queue.pop(completed))
+    {
+    }
+    for (int i = 0; i < WINDOW_COMMAND_COUNT; i++)
+    {
+        _inflight_count[i] = 0;
+    }
+}
+
+void UniWinCore::command_thread_main()
+{
+    WindowCommand command;
+    while (true)
+    {
+        if (g_command_queue.pop(command))
+        {
+            execute_command_from_thread(command);
+            // 完成队列满说明主线程没有及时取走，此时让出CPU等待
+            while (!g_completion_queue.push(command))
+            {
+                if (g_command_thread_stop.load(std::memory_order_acquire))
+                {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(g_command_mutex);
+        if (g_command_thread_stop.load(std::memory_order_acquire) && g_command_queue.is_empty())
+        {
+            break;  // 队列已空且收到停止请求
+        }
+        g_command_cv.wait(lock, [] {
+            return g_command_thread_stop.load(std::memory_order_acquire) || !g_command_queue.is_empty();
+        });
+    }
+}
+
+#ifdef _WIN32
+// 工作线程中执行命令：只使用投递给窗口线程、不等待其处理的调用（SWP_ASYNCWINDOWPOS、ShowWindowAsync）
+// native库的SetPosition等会同步调用SetWindowPos，跨线程时SendMessage给主线程，不能在这里使用
+void UniWinCore::execute_command_from_thread(const WindowCommand &command)
+{
+    HWND hwnd = (HWND)(intptr_t)g_native_window_handle.load(std::memory_order_acquire);
+    RECT rect;
+    if (!hwnd || !GetWindowRect(hwnd, &rect))
+    {
+        return;
+    }
+    // native库使用Unity坐标（主显示器左下角为原点，y向上）
+    int primary_height = GetSystemMetrics(SM_CYSCREEN);
+    UINT flags = SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE | SWP_ASYNCWINDOWPOS;
+    switch (command.type)
+    {
+    case WINDOW_COMMAND_SET_SIZE:
+        // 与native的SetSize相同，保持左下角不动
+        SetWindowPos(hwnd, nullptr, rect.left, rect.bottom - (int)command.y, (int)command.x, (int)command.y, flags);
+        break;
+    case WINDOW_COMMAND_SET_POSITION:
+        SetWindowPos(hwnd, nullptr, (int)command.x, primary_height - (int)command.y - (rect.bottom - rect.top), 0, 0,
+                     flags | SWP_NOSIZE);
+        break;
+    case WINDOW_COMMAND_SET_RECT:
+        if (command.value != 0)
+        {
+            ShowWindowAsync(hwnd, SW_RESTORE);
+        }
+        apply_window_rect(command.x, command.y, command.width, command.height);
+        break;
+    case WINDOW_COMMAND_SET_ZOOMED:
+        ShowWindowAsync(hwnd, command.value != 0 ? SW_MAXIMIZE : SW_RESTORE);
+        break;
+    case WINDOW_COMMAND_FIT_TO_MONITOR: {
+        // 监视器矩形在投递时由主线程从拓扑缓存填入；还原后的大小取自窗口的正常位置
+        if (IsZoomed(hwnd))
+        {
+            ShowWindowAsync(hwnd, SW_RESTORE);
+        }
+        WINDOWPLACEMENT placement = {};
+        placement.length = sizeof(WINDOWPLACEMENT);
+        if (command.width > 0.0f && GetWindowPlacement(hwnd, &placement))
+        {
+            int width = placement.rcNormalPosition.right - placement.rcNormalPosition.left;
+            int height = placement.rcNormalPosition.bottom - placement.rcNormalPosition.top;
+            int left = (int)(command.x + (command.width - width) / 2.0f);
+            int top = primary_height - (int)(command.y + command.height) + (int)((command.height - height) / 2.0f);
+            SetWindowPos(hwnd, nullptr, left, top, 0, 0, flags | SWP_NOSIZE);
+        }
+        ShowWindowAsync(hwnd, SW_MAXIMIZE);
+        break;
+    }
+    default:
+        break;
+    }
+}
+#else
+void UniWinCore::execute_command_from_thread(const WindowCommand &)
+{
+    // 其他平台不启动工作线程
+}
+#endif
+
+// 在主线程直接调用native
+void UniWinCore::execute_command(const WindowCommand &command)
+{
+    switch (command.type)
+    {
+    case WINDOW_COMMAND_SET_SIZE:
+        if (native_set_size)
+        {
+            native_set_size(command.x, command.y);
+        }
+        break;
+    case WINDOW_COMMAND_SET_POSITION:
+        if (native_set_position)
+        {
+            native_set_position(command.x, command.y);
+        }
+        break;
+    case WINDOW_COMMAND_SET_RECT:
+        if (command.value != 0 && native_set_zoomed)
+        {
+            native_set_zoomed(false);  // 并入的解除最大化
+        }
+        apply_window_rect(command.x, command.y, command.width, command.height);
+        break;
+    case WINDOW_COMMAND_SET_ZOOMED:
+        if (native_set_zoomed)
+        {
+            native_set_zoomed(command.value != 0);
+        }
+        break;
+    case WINDOW_COMMAND_FIT_TO_MONITOR:
+        if (native_fit_to_monitor)
+        {
+            native_fit_to_monitor(command.value);
+        }
+        else if (native_get_monitor_rectangle && native_get_size && native_set_position && native_set_zoomed)
+        {
+            // 与UniWindowController::fit_to_monitor相同：解除最大化、移到监视器中央、再最大化
+            float dx, dy, dw, dh;
+            native_get_monitor_rectangle(command.value, &dx, &dy, &dw, &dh);
+            if (native_is_zoomed && native_is_zoomed())
+            {
+                native_set_zoomed(false);
+            }
+            float ww, wh;
+            native_get_size(&ww, &wh);
+            native_set_position(dx + (dw - ww) / 2.0f, dy + (dh - wh) / 2.0f);
+            native_set_zoomed(true);
+        }
+        break;
+    default:
+        break;
+    }
 }
 
 bool UniWinCore::is_active()
 {
-    return native_is_active ? native_is_active() : false;
+    return get_window_state(WINDOW_STATE_ACTIVE).active;
 }
 
 bool UniWinCore::is_transparent()
@@ -451,14 +957,14 @@ bool UniWinCore::is_topmost()
 
 bool UniWinCore::is_maximized()
 {
-    bool result = native_is_maximized ? native_is_maximized() : false;
-    UtilityFunctions::print("UniWinCore::is_maximized returning: " + String(result ? "true" : "false"));
+    bool result = get_window_state(WINDOW_STATE_MAXIMIZED).maximized;
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "UniWinCore::is_maximized returning: " + String(result ? "true" : "false"));
     return result;
 }
 
 bool UniWinCore::is_minimized()
 {
-    return native_is_minimized ? native_is_minimized() : false;
+    return get_window_state(WINDOW_STATE_MINIMIZED).minimized;
 }
 
 void UniWinCore::set_transparent(bool transparent)
@@ -511,6 +1017,106 @@ void UniWinCore::set_clickthrough(bool clickthrough)
 
 void UniWinCore::set_position(float x, float y)
 {
+    if (_async_commands)
+    {
+        WindowCommand command;
+        command.type = WINDOW_COMMAND_SET_POSITION;
+        command.x = x;
+        command.y = y;
+        post_command(command);
+        return;
+    }
+    if (native_set_position)
+    {
+        native_set_position(x, y);
+        invalidate_window_state(WINDOW_STATE_POSITION);
+    }
+}
+
+void UniWinCore::set_native_window_handle(int64_t handle)
+{
+    g_native_window_handle.store(handle, std::memory_order_release);
+}
+
+void UniWinCore::set_window_rect(float x, float y, float width, float height)
+{
+    if (_async_commands)
+    {
+        WindowCommand command;
+        command.type = WINDOW_COMMAND_SET_RECT;
+        command.x = x;
+        command.y = y;
+        command.width = width;
+        command.height = height;
+        post_command(command);
+        return;
+    }
+    apply_window_rect(x, y, width, height);
+    invalidate_window_state(WINDOW_STATE_POSITION | WINDOW_STATE_SIZE);
+}
+
+bool UniWinCore::query_zoomed()
+{
+    return native_is_zoomed ? native_is_zoomed() : false;
+}
+
+bool UniWinCore::query_position(float *x, float *y)
+{
+    if (!native_get_position || !x || !y)
+    {
+        return false;
+    }
+    native_get_position(x, y);
+    return true;
+}
+
+bool UniWinCore::move_window_from_thread(float x, float y)
+{
+#ifdef _WIN32
+    HWND hwnd = (HWND)(intptr_t)g_native_window_handle.load(std::memory_order_acquire);
+    RECT rect;
+    if (!hwnd || !GetWindowRect(hwnd, &rect))
+    {
+        return false;
+    }
+    // 与apply_window_rect相同的坐标换算；ASYNCWINDOWPOS避免等待主线程处理消息
+    int primary_height = GetSystemMetrics(SM_CYSCREEN);
+    int top = primary_height - (int)y - (rect.bottom - rect.top);
+    SetWindowPos(hwnd, nullptr, (int)x, top, 0, 0,
+                 SWP_NOSIZE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE | SWP_ASYNCWINDOWPOS);
+    invalidate_window_state(WINDOW_STATE_POSITION);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// 在主线程或命令线程调用
+void UniWinCore::apply_window_rect(float x, float y, float width, float height)
+{
+#ifdef _WIN32
+    HWND hwnd = (HWND)(intptr_t)g_native_window_handle.load(std::memory_order_acquire);
+    if (hwnd && IsWindow(hwnd))
+    {
+        // native库使用Unity坐标（主显示器左下角为原点，y向上），换算为屏幕左上角原点
+        int primary_height = GetSystemMetrics(SM_CYSCREEN);
+        int left = (int)x;
+        int top = primary_height - (int)(y + height);
+        UINT flags = SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_NOACTIVATE;
+        // 在命令线程调用时不等待窗口线程处理（同步的跨线程SetWindowPos会SendMessage给主线程）
+        if (GetWindowThreadProcessId(hwnd, nullptr) != GetCurrentThreadId())
+        {
+            flags |= SWP_ASYNCWINDOWPOS;
+        }
+        SetWindowPos(hwnd, nullptr, left, top, (int)width, (int)height, flags);
+        return;
+    }
+#endif
+    // 没有单次设置矩形的native接口：先改大小再定位，保证最终位置正确
+    if (native_set_size)
+    {
+        native_set_size(width, height);
+    }
     if (native_set_position)
     {
         native_set_position(x, y);
@@ -521,15 +1127,27 @@ void UniWinCore::get_position(float *x, float *y)
 {
     if (native_get_position && x && y)
     {
-        native_get_position(x, y);
+        const WindowStateSnapshot &state = get_window_state(WINDOW_STATE_POSITION);
+        *x = state.x;
+        *y = state.y;
     }
 }
 
 void UniWinCore::set_size(float width, float height)
 {
+    if (_async_commands)
+    {
+        WindowCommand command;
+        command.type = WINDOW_COMMAND_SET_SIZE;
+        command.x = width;
+        command.y = height;
+        post_command(command);
+        return;
+    }
     if (native_set_size)
     {
         native_set_size(width, height);
+        invalidate_window_state(WINDOW_STATE_POSITION | WINDOW_STATE_SIZE);
     }
 }
 
@@ -537,22 +1155,22 @@ void UniWinCore::get_size(float *width, float *height)
 {
     if (native_get_size && width && height)
     {
-        native_get_size(width, height);
+        const WindowStateSnapshot &state = get_window_state(WINDOW_STATE_SIZE);
+        *width = state.width;
+        *height = state.height;
     }
 }
 
 int UniWinCore::get_monitor_count()
 {
-    return native_get_monitor_count ? native_get_monitor_count() : 1;
+    // 与拓扑一致：native函数不可用时为0，避免按全零矩形适配
+    return (int)get_monitor_topology().monitors.size();
 }
 
 void UniWinCore::get_monitor_size(int monitor_index, float *width, float *height)
 {
-    if (native_get_monitor_rectangle && width && height)
-    {
-        float x, y;
-        native_get_monitor_rectangle(monitor_index, &x, &y, width, height);
-    }
+    float x, y;
+    get_monitor_rectangle(monitor_index, &x, &y, width, height);
 }
 
 int UniWinCore::get_current_monitor()
@@ -562,15 +1180,15 @@ int UniWinCore::get_current_monitor()
 
 void UniWinCore::set_allow_drop_files(bool allow)
 {
-    UtilityFunctions::print("Setting allow drop files to: " + String(allow ? "true" : "false"));
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_DROP, "Setting allow drop files to: " + String(allow ? "true" : "false"));
     if (native_set_allow_drop)
     {
         native_set_allow_drop(allow);
-        UtilityFunctions::print("Allow drop files setting applied successfully");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_DROP, "Allow drop files setting applied successfully");
     }
     else
     {
-        UtilityFunctions::print("ERROR: native_set_allow_drop function pointer is null");
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_DROP, "native_set_allow_drop function pointer is null");
     }
 }
 
@@ -588,6 +1206,7 @@ void UniWinCore::set_cursor_position(float x, float y)
     {
         native_set_cursor_position(x, y);
     }
+    _input_sample_dirty = true;
 }
 
 int UniWinCore::get_mouse_buttons()
@@ -600,24 +1219,101 @@ int UniWinCore::get_modifier_keys()
     return native_get_modifier_keys ? native_get_modifier_keys() : 0;
 }
 
+const InputSample &UniWinCore::get_input_sample()
+{
+    // 同一帧内直接返回缓存；设置了采样频率时未到间隔也返回缓存
+    uint64_t frame = Engine::get_singleton()->get_process_frames();
+    if (_input_sample_dirty)
+    {
+        refresh_input_sample(frame, Time::get_singleton()->get_ticks_usec());
+    }
+    else if (_input_sample.frame != frame)
+    {
+        uint64_t now = Time::get_singleton()->get_ticks_usec();
+        if (_input_sample_rate <= 0 || now - _input_sample.time_usec >= 1000000ull / (uint64_t)_input_sample_rate)
+        {
+            refresh_input_sample(frame, now);
+        }
+    }
+    return _input_sample;
+}
+
+void UniWinCore::refresh_input_sample(uint64_t frame, uint64_t now)
+{
+    InputSample &sample = _input_sample;
+    get_cursor_position(&sample.x, &sample.y);
+    sample.buttons = get_mouse_buttons();
+    sample.modifiers = get_modifier_keys();
+    sample.time_usec = now;
+    sample.frame = frame;
+    _input_sample_dirty = false;
+
+    if (!_input_history.empty())
+    {
+        _input_history[_input_history_head] = sample;
+        _input_history_head = (_input_history_head + 1) % (int)_input_history.size();
+        _input_history_count = std::min(_input_history_count + 1, (int)_input_history.size());
+    }
+}
+
+void UniWinCore::set_input_sample_rate(int rate)
+{
+    _input_sample_rate = std::max(rate, 0);
+    _input_sample_dirty = true;
+}
+
+int UniWinCore::get_input_sample_rate()
+{
+    return _input_sample_rate;
+}
+
+void UniWinCore::set_input_history_size(int size)
+{
+    size = std::max(size, 0);
+    if (size == (int)_input_history.size())
+    {
+        return;
+    }
+    // 改变大小时丢弃旧的历史
+    _input_history.assign((size_t)size, InputSample());
+    _input_history_head = 0;
+    _input_history_count = 0;
+}
+
+int UniWinCore::get_input_history_size()
+{
+    return (int)_input_history.size();
+}
+
+int UniWinCore::get_input_history_count()
+{
+    return _input_history_count;
+}
+
+const InputSample &UniWinCore::get_input_history_sample(int age)
+{
+    int size = (int)_input_history.size();
+    return _input_history[(_input_history_head - 1 - age + size * 2) % size];
+}
+
 void UniWinCore::register_drop_files_callback(DropFilesCallback callback)
 {
-    UtilityFunctions::print("Registering drop files callback (wide character)...");
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_DROP, "Registering drop files callback (wide character)...");
     if (native_register_drop_files_callback)
     {
         bool success = native_register_drop_files_callback((WStringCallbackFunc)callback);
         if (success)
         {
-            UtilityFunctions::print("Drop files callback registered successfully");
+            UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_DROP, "Drop files callback registered successfully");
         }
         else
         {
-            UtilityFunctions::print("ERROR: Failed to register drop files callback");
+            UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_DROP, "Failed to register drop files callback");
         }
     }
     else
     {
-        UtilityFunctions::print("ERROR: native_register_drop_files_callback function pointer is null");
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_DROP, "native_register_drop_files_callback function pointer is null");
     }
 }
 
@@ -663,59 +1359,115 @@ String UniWinCore::save_file_panel(const String &title, const String &filters, c
     return save_file_panel_with_settings(title, filters, initial_path, "", 0);
 }
 
-String UniWinCore::open_file_panel_with_settings(const String &title, const String &filters,
-                                                 const String &initial_directory, const String &initial_file, int flags)
+static std::u16string _to_utf16(const String &text)
 {
-    if (!native_open_file_panel)
-    {
-        UtilityFunctions::print("OpenFilePanel function not available in native library");
-        return String();
-    }
+    Char16String encoded = text.utf16();
+    return std::u16string(encoded.get_data(), (size_t)encoded.length());
+}
+
+CompiledPanelSettings::CompiledPanelSettings(const String &title, const String &filter, const String &initial_file,
+                                             const String &initial_directory, const String &default_extension, int flags)
+    : _title(_to_utf16(title)),
+      _filter(_to_utf16(filter)),
+      _initial_file(_to_utf16(initial_file)),
+      _initial_directory(_to_utf16(initial_directory)),
+      _default_extension(_to_utf16(default_extension))
+{
+    // 空字符串传nullptr，由native使用默认值
+    _native.flags = flags;
+    _native.title = _title.empty() ? nullptr : _title.c_str();
+    _native.filter = _filter.empty() ? nullptr : _filter.c_str();
+    _native.initial_file = _initial_file.empty() ? nullptr : _initial_file.c_str();
+    _native.initial_directory = _initial_directory.empty() ? nullptr : _initial_directory.c_str();
+    _native.default_extension = _default_extension.empty() ? nullptr : _default_extension.c_str();
+}
 
-    // 创建缓冲区来接收结果
-    const int buffer_size = 4096;
-    char buffer[buffer_size];
-    memset(buffer, 0, buffer_size);
+// 单选结果只有一个路径，32K字符足以容纳Windows长路径
+static const int SINGLE_PANEL_BUFFER_CHARS = 32 * 1024;
+static std::atomic<int> g_multi_select_buffer_size{4 * 1024 * 1024};
 
-    // 创建类似Unity PanelSettings的结构
-    // 这里简化为直接传递参数，实际使用需要根据native库的API来调整
-    void *settings = nullptr; // TODO: 构建实际的设置结构
+void UniWinCore::set_multi_select_buffer_size(int bytes)
+{
+    g_multi_select_buffer_size.store(std::max(bytes, SINGLE_PANEL_BUFFER_CHARS * (int)sizeof(char16_t)), std::memory_order_relaxed);
+}
+
+int UniWinCore::get_multi_select_buffer_size()
+{
+    return g_multi_select_buffer_size.load(std::memory_order_relaxed);
+}
+
+// native面板是模态的，不能用更大的缓冲区重试（会再次弹出面板），也没有查询长度的接口
+// 因此按flags一次分配足够大的堆缓冲区，并把写满缓冲区的结果报告为截断
+static String _call_file_panel(FilePanelFunc func, const NativePanelSettings &settings, bool *truncated)
+{
+    const int allow_multiple = 4; // FLAG_ALLOW_MULTIPLE_SELECTION
+    int buffer_chars = (settings.flags & allow_multiple)
+                           ? g_multi_select_buffer_size.load(std::memory_order_relaxed) / (int)sizeof(char16_t)
+                           : SINGLE_PANEL_BUFFER_CHARS;
+    std::vector<char16_t> buffer((size_t)buffer_chars, u'\0');
 
-    bool success = native_open_file_panel(settings, buffer, buffer_size);
+    bool success = func(&settings, buffer.data(), (uint32_t)buffer_chars);
 
-    if (success && buffer[0] != '\0')
+    size_t length = 0;
+    while (length < buffer.size() && buffer[length] != u'\0')
     {
-        return String::utf8(buffer);
+        length++;
     }
-
-    return String();
+    bool full = length >= buffer.size() - 1;
+    if (truncated)
+    {
+        *truncated = success && full;
+    }
+    if (!success || length == 0)
+    {
+        return String();
+    }
+    if (full)
+    {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_DIALOG, "File panel result filled the whole buffer and may be truncated");
+        // 丢掉可能不完整的最后一行
+        while (length > 0 && buffer[length - 1] != u'\n')
+        {
+            length--;
+        }
+    }
+    return String::utf16(buffer.data(), (int)length);
 }
 
-String UniWinCore::save_file_panel_with_settings(const String &title, const String &filters,
-                                                 const String &initial_directory, const String &initial_file, int flags)
+String UniWinCore::open_file_panel_native(const NativePanelSettings &settings, bool *truncated)
 {
-    if (!native_save_file_panel)
+    if (!native_open_file_panel)
     {
-        UtilityFunctions::print("SaveFilePanel function not available in native library");
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_DIALOG, "OpenFilePanel function not available in native library");
         return String();
     }
+    return _call_file_panel(native_open_file_panel, settings, truncated);
+}
 
-    // 创建缓冲区来接收结果
-    const int buffer_size = 4096;
-    char buffer[buffer_size];
-    memset(buffer, 0, buffer_size);
-
-    // 创建类似Unity PanelSettings的结构
-    void *settings = nullptr; // TODO: 构建实际的设置结构
-
-    bool success = native_save_file_panel(settings, buffer, buffer_size);
-
-    if (success && buffer[0] != '\0')
+String UniWinCore::save_file_panel_native(const NativePanelSettings &settings, bool *truncated)
+{
+    if (!native_save_file_panel)
     {
-        return String::utf8(buffer);
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_DIALOG, "SaveFilePanel function not available in native library");
+        return String();
     }
+    return _call_file_panel(native_save_file_panel, settings, truncated);
+}
+
+String UniWinCore::open_file_panel_with_settings(const String &title, const String &filters,
+                                                 const String &initial_directory, const String &initial_file, int flags,
+                                                 bool *truncated)
+{
+    CompiledPanelSettings settings(title, filters, initial_file, initial_directory, "", flags);
+    return open_file_panel_native(settings.get_native(), truncated);
+}
 
-    return String();
+String UniWinCore::save_file_panel_with_settings(const String &title, const String &filters,
+                                                 const String &initial_directory, const String &initial_file, int flags,
+                                                 bool *truncated)
+{
+    CompiledPanelSettings settings(title, filters, initial_file, initial_directory, "", flags);
+    return save_file_panel_native(settings.get_native(), truncated);
 }
 
 // 新增的Unity兼容方法实现
@@ -726,20 +1478,29 @@ bool UniWinCore::is_bottommost()
 
 bool UniWinCore::is_zoomed()
 {
-    return native_is_zoomed ? native_is_zoomed() : false;
+    return get_window_state(WINDOW_STATE_ZOOMED).zoomed;
 }
 
 void UniWinCore::set_zoomed(bool zoomed)
 {
-    UtilityFunctions::print("UniWinCore::set_zoomed called with: " + String(zoomed ? "true" : "false"));
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "UniWinCore::set_zoomed called with: " + String(zoomed ? "true" : "false"));
+    if (_async_commands)
+    {
+        WindowCommand command;
+        command.type = WINDOW_COMMAND_SET_ZOOMED;
+        command.value = zoomed ? 1 : 0;
+        post_command(command);
+        return;
+    }
     if (native_set_zoomed)
     {
         native_set_zoomed(zoomed);
-        UtilityFunctions::print("Native SetMaximized called successfully");
+        invalidate_window_state();
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_WINDOW, "Native SetMaximized called successfully");
     }
     else
     {
-        UtilityFunctions::print("ERROR: native_set_zoomed function pointer is null");
+        UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_WINDOW, "native_set_zoomed function pointer is null");
     }
 }
 
@@ -857,17 +1618,36 @@ int UniWinCore::get_monitor_to_fit()
 
 void UniWinCore::fit_to_monitor(int monitor_index)
 {
-    UtilityFunctions::print("UniWinCore::fit_to_monitor called with monitor: " + String::num_int64(monitor_index));
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "UniWinCore::fit_to_monitor called with monitor: " + String::num_int64(monitor_index));
+    if (_async_commands)
+    {
+        WindowCommand command;
+        command.type = WINDOW_COMMAND_FIT_TO_MONITOR;
+        command.value = monitor_index;
+        // 命令线程不访问拓扑缓存，投递时填入监视器矩形
+        const MonitorTopology &topology = get_monitor_topology();
+        if (monitor_index >= 0 && monitor_index < (int)topology.monitors.size())
+        {
+            const MonitorRect &monitor = topology.monitors[monitor_index];
+            command.x = monitor.x;
+            command.y = monitor.y;
+            command.width = monitor.width;
+            command.height = monitor.height;
+        }
+        post_command(command);
+        return;
+    }
     if (native_fit_to_monitor)
     {
-        UtilityFunctions::print("Using native FitToMonitor function");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "Using native FitToMonitor function");
         native_fit_to_monitor(monitor_index);
-        UtilityFunctions::print("Native FitToMonitor called successfully");
+        invalidate_window_state();
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "Native FitToMonitor called successfully");
     }
     else
     {
-        UtilityFunctions::print("Native FitToMonitor not available - this is expected, as Unity version implements it in C# layer");
-        UtilityFunctions::print("FitToMonitor logic is implemented in UniWindowController::fit_to_monitor() instead");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "Native FitToMonitor not available - this is expected, as Unity version implements it in C# layer");
+        UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "FitToMonitor logic is implemented in UniWindowController::fit_to_monitor() instead");
     }
 }
 
@@ -881,19 +1661,111 @@ void UniWinCore::get_client_size(float *width, float *height)
 
 void UniWinCore::get_monitor_position(int monitor_index, float *x, float *y)
 {
-    if (native_get_monitor_rectangle && x && y)
+    float width, height;
+    get_monitor_rectangle(monitor_index, x, y, &width, &height);
+}
+
+void UniWinCore::get_monitor_rectangle(int monitor_index, float *x, float *y, float *width, float *height)
+{
+    if (!x || !y || !width || !height)
     {
-        float width, height;
-        native_get_monitor_rectangle(monitor_index, x, y, &width, &height);
+        return;
     }
+    const MonitorTopology &topology = get_monitor_topology();
+    if (monitor_index < 0 || monitor_index >= (int)topology.monitors.size())
+    {
+        return;
+    }
+    const MonitorRect &rect = topology.monitors[monitor_index];
+    *x = rect.x;
+    *y = rect.y;
+    *width = rect.width;
+    *height = rect.height;
 }
 
-void UniWinCore::get_monitor_rectangle(int monitor_index, float *x, float *y, float *width, float *height)
+const MonitorTopology &UniWinCore::get_monitor_topology()
 {
-    if (native_get_monitor_rectangle && x && y && width && height)
+    if (_monitor_topology_dirty.exchange(false, std::memory_order_acq_rel))
     {
-        native_get_monitor_rectangle(monitor_index, x, y, width, height);
+        refresh_monitor_topology();
     }
+    return _monitor_topology;
+}
+
+void UniWinCore::invalidate_monitor_topology()
+{
+    // 可能从native回调线程调用，只设置标志
+    _monitor_topology_dirty.store(true, std::memory_order_release);
+}
+
+void UniWinCore::refresh_monitor_topology()
+{
+    MonitorTopology &topology = _monitor_topology;
+    topology.monitors.clear();
+    topology.virtual_x = topology.virtual_y = 0.0f;
+    topology.virtual_width = topology.virtual_height = 0.0f;
+    topology.version++;
+
+    if (!native_get_monitor_count || !native_get_monitor_rectangle)
+    {
+        return;
+    }
+
+    int count = native_get_monitor_count();
+    topology.monitors.resize(std::max(count, 0));
+    float min_x = 0.0f, min_y = 0.0f, max_x = 0.0f, max_y = 0.0f;
+    for (int i = 0; i < count; i++)
+    {
+        MonitorRect &rect = topology.monitors[i];
+        native_get_monitor_rectangle(i, &rect.x, &rect.y, &rect.width, &rect.height);
+        if (i == 0)
+        {
+            min_x = rect.x;
+            min_y = rect.y;
+            max_x = rect.x + rect.width;
+            max_y = rect.y + rect.height;
+        }
+        else
+        {
+            min_x = std::min(min_x, rect.x);
+            min_y = std::min(min_y, rect.y);
+            max_x = std::max(max_x, rect.x + rect.width);
+            max_y = std::max(max_y, rect.y + rect.height);
+        }
+    }
+    topology.virtual_x = min_x;
+    topology.virtual_y = min_y;
+    topology.virtual_width = max_x - min_x;
+    topology.virtual_height = max_y - min_y;
+
+    // native库不提供DPI，按中心点匹配Godot的屏幕（两边的监视器顺序不保证一致）
+    // native矩形为Unity坐标（主显示器左下角为原点，y向上），先换算为屏幕坐标（左上角原点，y向下），
+    // 再加上Godot屏幕坐标的原点偏移（Godot以虚拟桌面左上角为原点，主显示器左上角位于其主屏幕位置）
+    DisplayServer *display = DisplayServer::get_singleton();
+    if (display)
+    {
+        int screen_count = display->get_screen_count();
+        int primary = display->get_primary_screen();
+        Vector2i origin = display->screen_get_position(primary);
+        float primary_height = (float)display->screen_get_size(primary).y;
+        for (MonitorRect &rect : topology.monitors)
+        {
+            float cx = rect.x + rect.width * 0.5f + origin.x;
+            float cy = primary_height - rect.y - rect.height * 0.5f + origin.y;
+            for (int s = 0; s < screen_count; s++)
+            {
+                Vector2i position = display->screen_get_position(s);
+                Vector2i size = display->screen_get_size(s);
+                if (cx >= position.x && cy >= position.y && cx < position.x + size.x && cy < position.y + size.y)
+                {
+                    rect.dpi = (float)display->screen_get_dpi(s);
+                    break;
+                }
+            }
+        }
+    }
+
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_MONITOR, "Monitor topology refreshed: " + String::num_int64(count) + " monitor(s)");
 }
 
 void UniWinCore::minimize_window()
@@ -901,6 +1773,7 @@ void UniWinCore::minimize_window()
     if (native_minimize_window)
     {
         native_minimize_window();
+        invalidate_window_state();
     }
 }
 
@@ -909,6 +1782,7 @@ void UniWinCore::maximize_window()
     if (native_maximize_window)
     {
         native_maximize_window();
+        invalidate_window_state();
     }
 }
 
@@ -917,5 +1791,6 @@ void UniWinCore::restore_window()
     if (native_restore_window)
     {
         native_restore_window();
+        invalidate_window_state();
     }
 }
\ No newline at end of file
@@ -4,6 +4,12 @@
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/color.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 using namespace godot;
 
 // 回调函数类型定义
@@ -13,14 +19,141 @@ typedef void (*WindowMovedCallback)(float x, float y);
 typedef void (*WindowResizedCallback)(float width, float height);
 typedef void (*MonitorChangedCallback)(int monitor_index);
 
+// 窗口状态的各个字段，按字段分别失效和刷新
+enum WindowStateField {
+    WINDOW_STATE_POSITION = 1 << 0,
+    WINDOW_STATE_SIZE = 1 << 1,
+    WINDOW_STATE_ACTIVE = 1 << 2,
+    WINDOW_STATE_MAXIMIZED = 1 << 3,
+    WINDOW_STATE_MINIMIZED = 1 << 4,
+    WINDOW_STATE_ZOOMED = 1 << 5,
+    WINDOW_STATE_ALL = (1 << 6) - 1
+};
+
+// 窗口状态快照 - 每个字段每帧最多从native读取一次，并且只在被读取时才刷新
+struct WindowStateSnapshot {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    bool active = false;
+    bool maximized = false;
+    bool minimized = false;
+    bool zoomed = false;
+    uint64_t frame = 0;     // 刷新时的process帧号
+    uint32_t valid = 0;     // 本帧已从native读取的字段（WindowStateField）
+};
+
+// 输入采样 - 光标位置、鼠标按键和修饰键每帧（或按采样间隔）最多从native读取一次
+struct InputSample {
+    float x = 0.0f;         // native坐标
+    float y = 0.0f;
+    int buttons = 0;
+    int modifiers = 0;
+    uint64_t time_usec = 0; // 采样时的Time::get_ticks_usec()
+    uint64_t frame = 0;     // 采样时的process帧号
+};
+
+// 监视器拓扑快照 - 一次遍历读取所有监视器，只在monitor_changed回调时失效
+struct MonitorRect {
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    float dpi = 0.0f;       // 0表示无法确定
+};
+
+struct MonitorTopology {
+    std::vector<MonitorRect> monitors;
+    // 虚拟桌面（所有监视器的外包矩形）
+    float virtual_x = 0.0f;
+    float virtual_y = 0.0f;
+    float virtual_width = 0.0f;
+    float virtual_height = 0.0f;
+    uint64_t version = 0;   // 每次重建加一
+};
+
+// native库的PANELSETTINGS结构（对应Unity的PanelSettings，字符串为UTF-16）
+struct NativePanelSettings {
+    int32_t struct_size = sizeof(NativePanelSettings);
+    int32_t flags = 0;
+    const char16_t* title = nullptr;
+    const char16_t* filter = nullptr;
+    const char16_t* initial_file = nullptr;
+    const char16_t* initial_directory = nullptr;
+    const char16_t* default_extension = nullptr;
+};
+
+// 预编码的面板设置：持有UTF-16字符串，native结构指向这些缓冲区
+// 创建后不可修改也不可复制，可以在线程间共享
+class CompiledPanelSettings {
+private:
+    std::u16string _title;
+    std::u16string _filter;
+    std::u16string _initial_file;
+    std::u16string _initial_directory;
+    std::u16string _default_extension;
+    NativePanelSettings _native;
+
+public:
+    CompiledPanelSettings(const String& title, const String& filter, const String& initial_file,
+                          const String& initial_directory, const String& default_extension, int flags);
+    CompiledPanelSettings(const CompiledPanelSettings&) = delete;
+    CompiledPanelSettings& operator=(const CompiledPanelSettings&) = delete;
+
+    const NativePanelSettings& get_native() const { return _native; }
+};
+
+// 异步窗口命令类型（同时也是合并槽位的顺序：先大小、再位置、再整体矩形、再最大化、最后适配监视器）
+enum WindowCommandType {
+    WINDOW_COMMAND_SET_SIZE = 0,
+    WINDOW_COMMAND_SET_POSITION,
+    WINDOW_COMMAND_SET_RECT,
+    WINDOW_COMMAND_SET_ZOOMED,
+    WINDOW_COMMAND_FIT_TO_MONITOR,
+    WINDOW_COMMAND_COUNT
+};
+
+struct WindowCommand {
+    int type = WINDOW_COMMAND_SET_POSITION;
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;     // SET_RECT的大小；FIT_TO_MONITOR时为监视器矩形（x/y同）
+    float height = 0.0f;
+    int value = 0;          // zoomed标志、监视器索引；SET_RECT时非0表示先解除最大化
+};
+
+// native库功能位（get_capabilities），一组native函数全部存在时对应的位才置位
+enum NativeCapability {
+    CAPABILITY_WINDOW_ATTACH = 1 << 0,      // AttachMyWindow/DetachWindow/IsActive
+    CAPABILITY_TRANSPARENCY = 1 << 1,       // SetTransparent/IsTransparent/SetAlphaValue
+    CAPABILITY_WINDOW_STYLE = 1 << 2,       // SetBorderless/SetTopmost/SetBottommost
+    CAPABILITY_CLICK_THROUGH = 1 << 3,
+    CAPABILITY_WINDOW_RECT = 1 << 4,        // Get/SetPosition、Get/SetSize
+    CAPABILITY_MAXIMIZE = 1 << 5,           // SetMaximized/IsMaximized
+    CAPABILITY_MONITORS = 1 << 6,           // GetMonitorCount/GetMonitorRectangle/GetCurrentMonitor
+    CAPABILITY_FIT_TO_MONITOR = 1 << 7,
+    CAPABILITY_CURSOR = 1 << 8,             // Get/SetCursorPosition
+    CAPABILITY_MOUSE_KEYBOARD = 1 << 9,     // GetMouseButtons/GetModifierKeys
+    CAPABILITY_DROP_FILES = 1 << 10,        // SetAllowDrop/RegisterDropFilesCallback
+    CAPABILITY_FILE_DIALOGS = 1 << 11,      // OpenFilePanel/SaveFilePanel
+    CAPABILITY_WINDOW_EVENTS = 1 << 12,     // 移动/缩放/样式/监视器变化回调
+    CAPABILITY_KEY_COLOR = 1 << 13,         // SetTransparentType/SetKeyColor（Unity扩展）
+};
+
 class UniWinCore {
 public:
     // 初始化和清理
     static bool initialize();
     static void cleanup();
+
+    // native函数在第一次调用时才解析；has_capability只解析所请求功能位涉及的函数
+    static bool has_capability(int capabilities);
+    static int get_capabilities();
     
     // 窗口控制
-    static bool attach_window();
+    // quiet为true时失败只记录DEBUG日志，由重试的调用方在最终失败时报告一次
+    static bool attach_window(bool quiet = false);
     static void detach_window();
     
     // 窗口状态查询
@@ -33,6 +166,20 @@ public:
     static bool is_minimized();
     static bool is_zoomed();
     
+    // 窗口状态快照（移动/缩放/样式变化回调或本地修改窗口时失效）
+    // fields为需要的字段，只有这些字段中已失效的才会从native重新读取
+    static const WindowStateSnapshot& get_window_state(uint32_t fields = WINDOW_STATE_ALL);
+    static void invalidate_window_state(uint32_t fields = WINDOW_STATE_ALL);
+    
+    // 异步命令模式：set_position/set_size/set_zoomed/fit_to_monitor 每帧合并后执行
+    // 同一帧内同类命令只保留最后一个，flush_commands()每帧调用一次
+    // Windows上投递到工作线程，以不等待窗口线程的方式应用；其他平台（macOS的AppKit只允许主线程操作窗口）
+    // 在flush_commands中于主线程执行
+    static void set_async_commands(bool enabled);
+    static bool get_async_commands();
+    static void flush_commands();
+    static bool pop_completed_command(WindowCommand* command);
+    
     // 基础窗口属性设置
     static void set_transparent(bool transparent);
     static void set_borderless(bool borderless);
@@ -72,6 +219,18 @@ public:
     static void get_position(float* x, float* y);
     static void set_size(float width, float height);
     static void get_size(float* width, float* height);
+
+    // 一次native操作同时设置位置和大小，避免两次窗口重排
+    static void set_window_rect(float x, float y, float width, float height);
+    // 附加窗口的native句柄，set_window_rect在Windows上直接使用
+    static void set_native_window_handle(int64_t handle);
+
+    // 可在任意线程调用：直接查询native，不经过状态快照和异步命令队列
+    static bool query_zoomed();
+    static bool query_position(float* x, float* y);
+    // 从任意线程移动窗口（native坐标）。Windows上以异步方式投递给窗口线程，不等待其处理；
+    // 其他平台窗口只能在主线程移动，返回false
+    static bool move_window_from_thread(float x, float y);
     static void get_client_size(float* width, float* height);
     
     // 多显示器支持
@@ -80,6 +239,10 @@ public:
     static void get_monitor_position(int monitor_index, float* x, float* y);
     static void get_monitor_rectangle(int monitor_index, float* x, float* y, float* width, float* height);
     static int get_current_monitor();
+
+    // 监视器拓扑缓存（主线程使用），invalidate可从任意线程调用
+    static const MonitorTopology& get_monitor_topology();
+    static void invalidate_monitor_topology();
     
     // 文件拖拽
     static void set_allow_drop_files(bool allow);
@@ -89,11 +252,22 @@ public:
     static void maximize_window();
     static void restore_window();
     
-    // 鼠标和键盘
+    // 鼠标和键盘（直接查询native，可在任意线程调用）
     static void get_cursor_position(float* x, float* y);
     static void set_cursor_position(float x, float y);
     static int get_mouse_buttons();
     static int get_modifier_keys();
+
+    // 共享输入采样（主线程使用）：同一帧内所有读取者共用一次native查询
+    static const InputSample& get_input_sample();
+    // 采样频率（Hz），0表示每帧采样一次；帧率高于该频率时多帧共用同一次采样
+    static void set_input_sample_rate(int rate);
+    static int get_input_sample_rate();
+    // 带时间戳的采样历史（环形缓冲区），0为不记录
+    static void set_input_history_size(int size);
+    static int get_input_history_size();
+    static int get_input_history_count();
+    static const InputSample& get_input_history_sample(int age);  // age=0为最新采样
     
     // 回调注册
     static void register_drop_files_callback(DropFilesCallback callback);
@@ -107,10 +281,21 @@ public:
     static String save_file_panel(const String& title, const String& filters, const String& initial_path);
     
     // 增强的文件对话框方法 (对应Unity的完整PanelSettings支持)
+    // 结果缓冲区在堆上按flags分配，truncated返回结果是否填满了缓冲区（可能被截断）
+    static String open_file_panel_native(const NativePanelSettings& settings, bool* truncated = nullptr);
+    static String save_file_panel_native(const NativePanelSettings& settings, bool* truncated = nullptr);
+
+    // 每次调用都会重新编码设置，重复打开时应缓存CompiledPanelSettings并使用*_native
     static String open_file_panel_with_settings(const String& title, const String& filters, 
-                                               const String& initial_directory, const String& initial_file, int flags);
+                                               const String& initial_directory, const String& initial_file, int flags,
+                                               bool* truncated = nullptr);
     static String save_file_panel_with_settings(const String& title, const String& filters, 
-                                               const String& initial_directory, const String& initial_file, int flags);
+                                               const String& initial_directory, const String& initial_file, int flags,
+                                               bool* truncated = nullptr);
+
+    // 多选时结果缓冲区的大小（字节），默认4MB
+    static void set_multi_select_buffer_size(int bytes);
+    static int get_multi_select_buffer_size();
 
 private:
     static bool _is_initialized;
@@ -125,6 +310,38 @@ private:
     static bool _hit_test_enabled;
     static Color _key_color;
     
+    // 窗口状态快照
+    static WindowStateSnapshot _window_state;
+    static std::atomic<uint32_t> _window_state_dirty;
+    static void refresh_window_state(uint32_t fields);
+    static void apply_window_rect(float x, float y, float width, float height);
+
+    static InputSample _input_sample;
+    static bool _input_sample_dirty;
+    static int _input_sample_rate;
+    static std::vector<InputSample> _input_history;
+    static int _input_history_head;     // 下一个写入位置
+    static int _input_history_count;
+    static void refresh_input_sample(uint64_t frame, uint64_t now);
+
+    static MonitorTopology _monitor_topology;
+    static std::atomic<bool> _monitor_topology_dirty;
+    static void refresh_monitor_topology();
+    
+    // 异步命令状态（除工作线程外只在主线程访问）
+    static bool _async_commands;
+    static WindowCommand _pending_commands[WINDOW_COMMAND_COUNT];
+    static bool _has_pending_command[WINDOW_COMMAND_COUNT];
+    static WindowCommand _inflight_commands[WINDOW_COMMAND_COUNT];
+    static int _inflight_count[WINDOW_COMMAND_COUNT];
+    static const WindowCommand* latest_command(int type);
+    static void post_command(const WindowCommand& command);
+    static void execute_command(const WindowCommand& command);
+    static void execute_command_from_thread(const WindowCommand& command);  // 仅Windows
+    static void start_command_thread();
+    static void stop_command_thread();
+    static void command_thread_main();
+    
     // 函数指针声明
     static bool load_native_library();
     static void unload_native_library();
@@ -0,0 +1,215 @@
+#include "uniwinc_drop_resolver.h"
+#include "uniwinc_file_dialog.h"
+
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+
+using namespace godot;
+
+namespace fs = std::filesystem;
+
+UniWinDropResolver::UniWinDropResolver() {
+    unsigned int count = std::thread::hardware_concurrency();
+    count = std::max(1u, std::min(count, 4u));
+    for (unsigned int i = 0; i < count; i++) {
+        _workers.emplace_back(&UniWinDropResolver::_worker_main, this);
+    }
+}
+
+UniWinDropResolver::~UniWinDropResolver() {
+    {
+        std::lock_guard<std::mutex> lock(_task_mutex);
+        _stop.store(true, std::memory_order_release);
+        _tasks.clear();
+    }
+    _task_cv.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+static std::string _to_lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return text;
+}
+
+void UniWinDropResolver::submit(const PackedStringArray& paths, int max_depth, const std::vector<FileFilter>& filters, int max_entries) {
+    if (paths.is_empty()) {
+        return;
+    }
+
+    std::shared_ptr<Request> request = std::make_shared<Request>();
+    request->results.resize(paths.size());
+    request->remaining.store((int)paths.size(), std::memory_order_relaxed);
+    request->max_depth = std::max(max_depth, 0);
+    request->max_entries = max_entries > 0 ? (size_t)max_entries : SIZE_MAX;
+    bool wildcard = false;
+    for (const FileFilter& filter : filters) {
+        for (int i = 0; i < filter.extensions.size() && !wildcard; i++) {
+            String extension = filter.extensions[i].strip_edges().to_lower();
+            if (extension.begins_with(".")) {
+                extension = extension.substr(1);
+            }
+            wildcard = extension == "*" || extension.is_empty();
+            request->extensions.push_back(extension.utf8().get_data());
+        }
+    }
+    if (wildcard) {
+        request->extensions.clear();  // 有通配过滤器时不过滤
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_task_mutex);
+        for (int i = 0; i < paths.size(); i++) {
+            Task task;
+            task.request = request;
+            task.index = (size_t)i;
+            task.root = paths[i].utf8().get_data();
+            _tasks.push_back(std::move(task));
+        }
+    }
+    _task_cv.notify_all();
+}
+
+bool UniWinDropResolver::poll(Array* entries) {
+    std::shared_ptr<Request> request;
+    {
+        std::lock_guard<std::mutex> lock(_completed_mutex);
+        if (_completed.empty()) {
+            return false;
+        }
+        request = _completed.front();
+        _completed.erase(_completed.begin());
+    }
+
+    static const char* type_names[] = { "file", "directory", "missing" };
+    entries->clear();
+    for (const std::vector<Entry>& group : request->results) {
+        for (const Entry& entry : group) {
+            Dictionary info;
+            info["path"] = String::utf8(entry.path.c_str());
+            info["type"] = type_names[entry.type];
+            info["size"] = (int64_t)entry.size;
+            info["modified_time"] = entry.modified_time;
+            info["extension"] = String::utf8(entry.extension.c_str());
+            info["depth"] = entry.depth;
+            entries->append(info);
+        }
+    }
+    return true;
+}
+
+void UniWinDropResolver::_worker_main() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(_task_mutex);
+            _task_cv.wait(lock, [this] {
+                return _stop.load(std::memory_order_acquire) || !_tasks.empty();
+            });
+            if (_stop.load(std::memory_order_acquire)) {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        _resolve(task);
+
+        // 最后一个完成的根路径负责把整个请求交给主线程
+        if (task.request->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(_completed_mutex);
+            _completed.push_back(task.request);
+        }
+    }
+}
+
+static int64_t _to_unix_time(fs::file_time_type time) {
+    // C++17没有file_clock到system_clock的转换，用当前时间差近似
+    auto system_time = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+            time - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
+    return std::chrono::duration_cast<std::chrono::seconds>(system_time.time_since_epoch()).count();
+}
+
+static bool _fill_entry(const fs::path& path, UniWinDropResolver::Entry& entry) {
+    std::error_code error;
+    fs::file_status status = fs::status(path, error);
+    if (error || !fs::exists(status)) {
+        entry.type = 2;
+        return false;
+    }
+    entry.type = fs::is_directory(status) ? 1 : 0;
+    if (entry.type == 0) {
+        uintmax_t size = fs::file_size(path, error);
+        entry.size = error ? 0 : (uint64_t)size;
+    }
+    fs::file_time_type time = fs::last_write_time(path, error);
+    if (!error) {
+        entry.modified_time = _to_unix_time(time);
+    }
+    return true;
+}
+
+bool UniWinDropResolver::_matches(const Request& request, const std::string& extension) {
+    if (request.extensions.empty()) {
+        return true;
+    }
+    return std::find(request.extensions.begin(), request.extensions.end(), extension) != request.extensions.end();
+}
+
+void UniWinDropResolver::_resolve(Task& task) {
+    Request& request = *task.request;
+    std::vector<Entry>& results = request.results[task.index];
+
+    fs::path root = fs::u8path(task.root);
+    Entry root_entry;
+    root_entry.path = task.root;
+    root_entry.extension = _to_lower(root.extension().u8string());
+    if (!root_entry.extension.empty() && root_entry.extension[0] == '.') {
+        root_entry.extension.erase(0, 1);
+    }
+    bool exists = _fill_entry(root, root_entry);
+
+    // 直接拖入的文件也按过滤器筛选，目录和不存在的路径总是保留
+    if (root_entry.type != 0 || _matches(request, root_entry.extension)) {
+        results.push_back(root_entry);
+        request.entry_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!exists || root_entry.type != 1 || request.max_depth <= 0) {
+        return;
+    }
+
+    std::error_code error;
+    fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, error);
+    fs::recursive_directory_iterator end;
+    for (; !error && it != end; it.increment(error)) {
+        if (_stop.load(std::memory_order_relaxed) ||
+                request.entry_count.load(std::memory_order_relaxed) >= request.max_entries) {
+            break;
+        }
+
+        int depth = it.depth() + 1;
+        if (depth >= request.max_depth) {
+            it.disable_recursion_pending();
+        }
+
+        const fs::path& path = it->path();
+        Entry entry;
+        entry.path = path.u8string();
+        entry.depth = depth;
+        entry.extension = _to_lower(path.extension().u8string());
+        if (!entry.extension.empty() && entry.extension[0] == '.') {
+            entry.extension.erase(0, 1);
+        }
+        _fill_entry(path, entry);
+        if (entry.type == 0 && !_matches(request, entry.extension)) {
+            continue;
+        }
+        results.push_back(std::move(entry));
+        request.entry_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef UNIWINC_DROP_RESOLVER_H
+#define UNIWINC_DROP_RESOLVER_H
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace godot;
+
+class FileFilter;
+
+// 拖放文件的后台元数据解析 - 工作线程池负责stat、目录展开和扩展名过滤
+// 主线程只提交任务和取回结果，不会等待磁盘I/O
+class UniWinDropResolver {
+public:
+    struct Entry {
+        std::string path;       // UTF-8
+        std::string extension;  // 小写，不含点
+        int type = 0;           // 0=文件 1=目录 2=不存在
+        uint64_t size = 0;
+        int64_t modified_time = 0;  // Unix时间（秒）
+        int depth = 0;          // 0为直接拖入的路径
+    };
+
+private:
+    struct Request {
+        std::vector<std::vector<Entry>> results;  // 按拖入顺序，每个根路径一组
+        std::atomic<int> remaining{0};
+        std::atomic<size_t> entry_count{0};
+        int max_depth = 0;
+        size_t max_entries = 0;
+        std::vector<std::string> extensions;  // 空表示不过滤
+    };
+
+    struct Task {
+        std::shared_ptr<Request> request;
+        size_t index = 0;
+        std::string root;
+    };
+
+    std::vector<std::thread> _workers;
+    std::deque<Task> _tasks;
+    std::mutex _task_mutex;
+    std::condition_variable _task_cv;
+    std::vector<std::shared_ptr<Request>> _completed;
+    std::mutex _completed_mutex;
+    std::atomic<bool> _stop{false};
+
+public:
+    UniWinDropResolver();
+    ~UniWinDropResolver();
+
+    // 提交一次拖放，max_depth为目录展开深度（0为不展开），filters为空时不过滤
+    void submit(const PackedStringArray& paths, int max_depth, const std::vector<FileFilter>& filters, int max_entries);
+
+    // 取回一个已完成的拖放，转换为Dictionary数组（主线程调用）
+    bool poll(Array* entries);
+
+private:
+    void _worker_main();
+    void _resolve(Task& task);
+    static bool _matches(const Request& request, const std::string& extension);
+};
+
+#endif // UNIWINC_DROP_RESOLVER_H
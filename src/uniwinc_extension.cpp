@@ -1,6 +1,11 @@
 #include "uniwinc_extension.h"
 #include "uniwinc_controller.h"
 #include "uniwinc_file_dialog.h"
+#include "uniwinc_hit_tester.h"
+#include "uniwinc_alpha_mask_cache.h"
+#include "uniwinc_spatial_grid.h"
+#include "uniwinc_log.h"
+#include "uniwinc_startup_trace.h"
 
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
@@ -11,12 +16,17 @@ void initialize_uniwinc_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+    UNIWINC_TRACE_SCOPE("initialize_uniwinc_module");
     
     // 注册自定义类
     ClassDB::register_class<UniWindowController>();
     ClassDB::register_class<UniWinFileDialog>();
+    ClassDB::register_class<UniWinHitTester>();
+    ClassDB::register_class<AlphaMaskCache>();
+    ClassDB::register_class<UniWinSpatialGrid>();
+    ClassDB::register_abstract_class<UniWinLog>();
     
-    UtilityFunctions::print("UniWindowController GDExtension initialized");
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "UniWindowController GDExtension initialized");
 }
 
 void uninitialize_uniwinc_module(ModuleInitializationLevel p_level) {
@@ -24,7 +34,7 @@ void uninitialize_uniwinc_module(ModuleInitializationLevel p_level) {
         return;
     }
     
-    UtilityFunctions::print("UniWindowController GDExtension uninitialized");
+    UNIWINC_LOG_DEBUG(UniWinLog::CATEGORY_CORE, "UniWindowController GDExtension uninitialized");
 }
 
 extern "C" {
@@ -33,6 +43,10 @@ extern "C" {
         const GDExtensionClassLibraryPtr p_library,
         GDExtensionInitialization *r_initialization
     ) {
+        // 启动时间线以此为原点
+        UniWinStartupTrace::start();
+        UniWinStartupTrace::mark("gdextension_init");
+        
         godot::GDExtensionBinding::InitObject init_obj(p_get_proc_address, p_library, r_initialization);
         
         init_obj.register_initializer(initialize_uniwinc_module);
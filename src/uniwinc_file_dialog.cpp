@@ -1,11 +1,22 @@
 #include "uniwinc_file_dialog.h"
 #include "uniwinc_core.h"
+#include "uniwinc_log.h"
 
+#include <godot_cpp/classes/display_server.hpp>
 #include <godot_cpp/core/class_db.hpp>
-#include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 using namespace godot;
 
+// 当前打开了面板的窗口（同步和异步对话框共用）
+static std::mutex g_panel_mutex;
+static std::unordered_set<int64_t> g_open_panel_windows;
+static std::atomic<int64_t> g_next_request_id{1};
+
 // FileFilter 实现
 String FileFilter::to_string() const {
     String result = title + String("\t");
@@ -31,6 +42,23 @@ String FileFilter::join_filters(const std::vector<FileFilter>& filters) {
     return result;
 }
 
+std::vector<FileFilter> FileFilter::parse_pairs(const PackedStringArray& pairs) {
+    std::vector<FileFilter> filters;
+    for (int i = 0; i < pairs.size(); i += 2) {
+        if (i + 1 < pairs.size()) {
+            String title = pairs[i];
+            PackedStringArray extensions;
+            String ext_str = pairs[i + 1];
+            PackedStringArray ext_list = ext_str.split(";");
+            for (int j = 0; j < ext_list.size(); j++) {
+                extensions.append(ext_list[j].strip_edges());
+            }
+            filters.push_back(FileFilter(title, extensions));
+        }
+    }
+    return filters;
+}
+
 void UniWinFileDialog::_bind_methods() {
     // 枚举绑定
     BIND_ENUM_CONSTANT(OPEN_FILE);
@@ -77,6 +105,10 @@ void UniWinFileDialog::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_dialog_type"), &UniWinFileDialog::get_dialog_type);
     ADD_PROPERTY(PropertyInfo(Variant::INT, "dialog_type", PROPERTY_HINT_ENUM, "OpenFile,SaveFile,OpenDirectory,OpenMultipleFiles"), "set_dialog_type", "get_dialog_type");
 
+    ClassDB::bind_method(D_METHOD("set_window_id", "window_id"), &UniWinFileDialog::set_window_id);
+    ClassDB::bind_method(D_METHOD("get_window_id"), &UniWinFileDialog::get_window_id);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "window_id"), "set_window_id", "get_window_id");
+
     // 标志设置方法
     ClassDB::bind_method(D_METHOD("set_file_must_exist", "must_exist"), &UniWinFileDialog::set_file_must_exist);
     ClassDB::bind_method(D_METHOD("get_file_must_exist"), &UniWinFileDialog::get_file_must_exist);
@@ -108,6 +140,21 @@ void UniWinFileDialog::_bind_methods() {
     ClassDB::bind_method(D_METHOD("save_file_dialog"), &UniWinFileDialog::save_file_dialog);
     ClassDB::bind_method(D_METHOD("open_directory_dialog"), &UniWinFileDialog::open_directory_dialog);
 
+    // 异步对话框方法
+    ClassDB::bind_method(D_METHOD("open_file_dialog_async"), &UniWinFileDialog::open_file_dialog_async);
+    ClassDB::bind_method(D_METHOD("open_file_dialog_multiple_async"), &UniWinFileDialog::open_file_dialog_multiple_async);
+    ClassDB::bind_method(D_METHOD("save_file_dialog_async"), &UniWinFileDialog::save_file_dialog_async);
+    ClassDB::bind_method(D_METHOD("open_directory_dialog_async"), &UniWinFileDialog::open_directory_dialog_async);
+    ClassDB::bind_method(D_METHOD("cancel_dialog", "request_id"), &UniWinFileDialog::cancel_dialog, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("is_dialog_pending"), &UniWinFileDialog::is_dialog_pending);
+    ClassDB::bind_method(D_METHOD("get_pending_request_id"), &UniWinFileDialog::get_pending_request_id);
+    ClassDB::bind_method(D_METHOD("is_result_truncated"), &UniWinFileDialog::is_result_truncated);
+    ClassDB::bind_static_method("UniWinFileDialog", D_METHOD("is_panel_open", "window_id"), &UniWinFileDialog::is_panel_open, DEFVAL(0));
+    ClassDB::bind_static_method("UniWinFileDialog", D_METHOD("set_multi_select_buffer_size", "bytes"), &UniWinFileDialog::set_multi_select_buffer_size);
+    ClassDB::bind_static_method("UniWinFileDialog", D_METHOD("get_multi_select_buffer_size"), &UniWinFileDialog::get_multi_select_buffer_size);
+
+    ADD_SIGNAL(MethodInfo("dialog_completed", PropertyInfo(Variant::PACKED_STRING_ARRAY, "paths"), PropertyInfo(Variant::INT, "request_id")));
+
     // 静态便捷方法
     ClassDB::bind_static_method("UniWinFileDialog", D_METHOD("open_file", "title", "filters", "default_path"), &UniWinFileDialog::open_file, DEFVAL(""), DEFVAL(PackedStringArray()), DEFVAL(""));
     ClassDB::bind_static_method("UniWinFileDialog", D_METHOD("open_files", "title", "filters", "default_path"), &UniWinFileDialog::open_files, DEFVAL(""), DEFVAL(PackedStringArray()), DEFVAL(""));
@@ -122,13 +169,17 @@ UniWinFileDialog::UniWinFileDialog() {
     _initial_file = "";
     _default_extension = "";
     _flags = 0;
+    _window_id = DisplayServer::MAIN_WINDOW_ID;
+    _result_truncated = false;
 }
 
 UniWinFileDialog::~UniWinFileDialog() {
+    // 面板打开期间_async_self保持引用，析构时不会有未完成的请求指向自身
 }
 
 void UniWinFileDialog::set_title(const String& title) {
     _title = title;
+    _invalidate_settings();
 }
 
 String UniWinFileDialog::get_title() const {
@@ -136,19 +187,8 @@ String UniWinFileDialog::get_title() const {
 }
 
 void UniWinFileDialog::set_filters(const PackedStringArray& filters) {
-    _filters.clear();
-    for (int i = 0; i < filters.size(); i += 2) {
-        if (i + 1 < filters.size()) {
-            String title = filters[i];
-            PackedStringArray extensions;
-            String ext_str = filters[i + 1];
-            PackedStringArray ext_list = ext_str.split(";");
-            for (int j = 0; j < ext_list.size(); j++) {
-                extensions.append(ext_list[j].strip_edges());
-            }
-            _filters.push_back(FileFilter(title, extensions));
-        }
-    }
+    _filters = FileFilter::parse_pairs(filters);
+    _invalidate_settings();
 }
 
 PackedStringArray UniWinFileDialog::get_filters() const {
@@ -167,14 +207,17 @@ PackedStringArray UniWinFileDialog::get_filters() const {
 
 void UniWinFileDialog::add_filter(const String& title, const PackedStringArray& extensions) {
     _filters.push_back(FileFilter(title, extensions));
+    _invalidate_settings();
 }
 
 void UniWinFileDialog::clear_filters() {
     _filters.clear();
+    _invalidate_settings();
 }
 
 void UniWinFileDialog::set_initial_directory(const String& directory) {
     _initial_directory = directory;
+    _invalidate_settings();
 }
 
 String UniWinFileDialog::get_initial_directory() const {
@@ -183,6 +226,7 @@ String UniWinFileDialog::get_initial_directory() const {
 
 void UniWinFileDialog::set_initial_file(const String& file) {
     _initial_file = file;
+    _invalidate_settings();
 }
 
 String UniWinFileDialog::get_initial_file() const {
@@ -191,6 +235,7 @@ String UniWinFileDialog::get_initial_file() const {
 
 void UniWinFileDialog::set_default_extension(const String& extension) {
     _default_extension = extension;
+    _invalidate_settings();
 }
 
 String UniWinFileDialog::get_default_extension() const {
@@ -205,6 +250,14 @@ UniWinFileDialog::DialogType UniWinFileDialog::get_dialog_type() const {
     return _dialog_type;
 }
 
+void UniWinFileDialog::set_window_id(int64_t window_id) {
+    _window_id = window_id;
+}
+
+int64_t UniWinFileDialog::get_window_id() const {
+    return _window_id;
+}
+
 // 标志设置方法的实现
 void UniWinFileDialog::set_file_must_exist(bool must_exist) {
     _set_flag(FLAG_FILE_MUST_EXIST, must_exist);
@@ -287,6 +340,57 @@ String UniWinFileDialog::open_directory_dialog() {
     return _execute_dialog();
 }
 
+int64_t UniWinFileDialog::open_file_dialog_async() {
+    return _start_async(_dialog_type == OPEN_MULTIPLE_FILES ? OPEN_MULTIPLE_FILES : OPEN_FILE);
+}
+
+int64_t UniWinFileDialog::open_file_dialog_multiple_async() {
+    return _start_async(OPEN_MULTIPLE_FILES);
+}
+
+int64_t UniWinFileDialog::save_file_dialog_async() {
+    return _start_async(SAVE_FILE);
+}
+
+int64_t UniWinFileDialog::open_directory_dialog_async() {
+    return _start_async(OPEN_DIRECTORY);
+}
+
+bool UniWinFileDialog::cancel_dialog(int64_t request_id) {
+    if (!_async_request || (request_id != 0 && request_id != _async_request->id)) {
+        return false;
+    }
+    // 立即以空结果完成；窗口占用要等native面板真正关闭后由工作线程释放
+    _async_request->cancelled.store(true, std::memory_order_release);
+    _finish_async(_async_request->id);
+    return true;
+}
+
+bool UniWinFileDialog::is_dialog_pending() const {
+    return _async_request != nullptr;
+}
+
+int64_t UniWinFileDialog::get_pending_request_id() const {
+    return _async_request ? _async_request->id : 0;
+}
+
+bool UniWinFileDialog::is_result_truncated() const {
+    return _result_truncated;
+}
+
+void UniWinFileDialog::set_multi_select_buffer_size(int bytes) {
+    UniWinCore::set_multi_select_buffer_size(bytes);
+}
+
+int UniWinFileDialog::get_multi_select_buffer_size() {
+    return UniWinCore::get_multi_select_buffer_size();
+}
+
+bool UniWinFileDialog::is_panel_open(int64_t window_id) {
+    std::lock_guard<std::mutex> lock(g_panel_mutex);
+    return g_open_panel_windows.count(window_id) > 0;
+}
+
 String UniWinFileDialog::open_file(const String& title, const PackedStringArray& filters, const String& default_path) {
     Ref<UniWinFileDialog> dialog;
     dialog.instantiate();
@@ -359,60 +463,184 @@ String UniWinFileDialog::open_directory(const String& title, const String& defau
 }
 
 // 私有方法实现
-PanelSettings UniWinFileDialog::_create_panel_settings() const {
-    PanelSettings settings;
-    settings.title = _title;
-    settings.filters = _filters;
-    settings.initial_file = _initial_file;
-    settings.initial_directory = _initial_directory;
-    settings.default_extension = _default_extension;
-    settings.flags = _flags;
-    return settings;
+std::shared_ptr<const CompiledPanelSettings> UniWinFileDialog::_get_compiled_settings() {
+    if (!_compiled_settings) {
+        _compiled_settings = std::make_shared<const CompiledPanelSettings>(_title, FileFilter::join_filters(_filters),
+                _initial_file, _initial_directory, _default_extension, _flags);
+    }
+    return _compiled_settings;
+}
+
+void UniWinFileDialog::_invalidate_settings() {
+    // 进行中的异步请求持有旧设置的引用，这里只丢弃缓存
+    _compiled_settings.reset();
 }
 
 PackedStringArray UniWinFileDialog::_parse_result_paths(const String& result) const {
+    // 单次扫描：先按换行数预分配，再逐行去空白后写入，不生成split的中间数组
+    const char32_t* text = result.ptr();
+    int64_t length = result.length();
+    if (!text || length == 0) {
+        return PackedStringArray();
+    }
+
+    int64_t segments = 1;
+    for (int64_t i = 0; i < length; i++) {
+        if (text[i] == U'\n') {
+            segments++;
+        }
+    }
+
     PackedStringArray files;
-    
-    if (!result.is_empty()) {
-        PackedStringArray lines = result.split("\n");
-        for (int i = 0; i < lines.size(); i++) {
-            String file = lines[i].strip_edges();
-            if (!file.is_empty()) {
-                files.append(file);
-            }
+    files.resize(segments);
+    String* dst = files.ptrw();
+    int64_t count = 0;
+
+    int64_t line_start = 0;
+    while (line_start <= length) {
+        int64_t line_end = line_start;
+        while (line_end < length && text[line_end] != U'\n') {
+            line_end++;
+        }
+        int64_t begin = line_start;
+        int64_t end = line_end;
+        while (begin < end && (uint32_t)text[begin] <= 32) {
+            begin++;
         }
+        while (end > begin && (uint32_t)text[end - 1] <= 32) {
+            end--;
+        }
+        if (end > begin) {
+            dst[count++] = result.substr(begin, end - begin);
+        }
+        line_start = line_end + 1;
     }
-    
+
+    files.resize(count);
     return files;
 }
 
 String UniWinFileDialog::_execute_dialog() {
-    PanelSettings settings = _create_panel_settings();
-    String filters_str = FileFilter::join_filters(settings.filters);
-    
-    switch (_dialog_type) {
-        case OPEN_FILE:
+    if (!_acquire_panel(_window_id)) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_DIALOG, "A file panel is already open for this window");
+        return "";
+    }
+    bool truncated = false;
+    String result = _run_dialog(_dialog_type, *_get_compiled_settings(), &truncated);
+    _release_panel(_window_id);
+    _result_truncated = truncated;
+    return result;
+}
+
+String UniWinFileDialog::_run_dialog(DialogType type, const CompiledPanelSettings& settings, bool* truncated) {
+    // 只复制native结构调整标志位，不做任何字符串处理
+    NativePanelSettings native = settings.get_native();
+
+    switch (type) {
         case OPEN_MULTIPLE_FILES:
-            return UniWinCore::open_file_panel(settings.title, filters_str, settings.initial_directory);
-            
+            native.flags |= FLAG_ALLOW_MULTIPLE_SELECTION;
+            return UniWinCore::open_file_panel_native(native, truncated);
+
+        case OPEN_FILE:
+            return UniWinCore::open_file_panel_native(native, truncated);
+
         case SAVE_FILE:
-            return UniWinCore::save_file_panel(settings.title, filters_str, settings.initial_directory);
-            
+            return UniWinCore::save_file_panel_native(native, truncated);
+
         case OPEN_DIRECTORY:
-            // 目录选择可能需要特殊处理
-            return UniWinCore::open_file_panel(settings.title, "", settings.initial_directory);
-            
+            // 目录选择不使用过滤器和初始文件
+            native.filter = nullptr;
+            native.initial_file = nullptr;
+            return UniWinCore::open_file_panel_native(native, truncated);
+
         default:
-            UtilityFunctions::print("Unknown dialog type");
+            UNIWINC_LOG_ERROR(UniWinLog::CATEGORY_DIALOG, "Unknown dialog type");
             return "";
     }
 }
 
+int64_t UniWinFileDialog::_start_async(DialogType type) {
+    if (_async_request) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_DIALOG, "This dialog already has a pending request");
+        return 0;
+    }
+    if (!_acquire_panel(_window_id)) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_DIALOG, "A file panel is already open for this window");
+        return 0;
+    }
+
+    // 工作线程共享不可变的编码设置，不访问对象本身
+    std::shared_ptr<AsyncRequest> request = std::make_shared<AsyncRequest>();
+    request->id = g_next_request_id.fetch_add(1, std::memory_order_relaxed);
+    request->window_id = _window_id;
+    request->type = type;
+    request->settings = _get_compiled_settings();
+
+    _async_request = request;
+    _async_self = Ref<UniWinFileDialog>(this);
+
+#ifdef _WIN32
+    // native面板是模态的，无法中途关闭，线程分离后由请求状态自行收尾
+    std::thread(&UniWinFileDialog::_async_main, request, get_instance_id()).detach();
+#else
+    // macOS的NSOpenPanel/NSSavePanel只能在主线程使用：在主线程上同步运行面板，
+    // 调用会阻塞到面板关闭，但信号仍在之后的空闲时间发出，调用方的写法不变
+    _async_main(request, get_instance_id());
+#endif
+    return request->id;
+}
+
+void UniWinFileDialog::_async_main(std::shared_ptr<AsyncRequest> request, uint64_t owner_id) {
+    request->result = _run_dialog(request->type, *request->settings, &request->truncated);
+    _release_panel(request->window_id);
+
+    if (!request->cancelled.load(std::memory_order_acquire)) {
+        callable_mp_static(&UniWinFileDialog::_deliver_async_result).bind(owner_id, request->id).call_deferred();
+    }
+}
+
+void UniWinFileDialog::_deliver_async_result(uint64_t owner_id, int64_t request_id) {
+    UniWinFileDialog* dialog = Object::cast_to<UniWinFileDialog>(ObjectDB::get_instance(owner_id));
+    if (dialog) {
+        dialog->_finish_async(request_id);
+    }
+}
+
+void UniWinFileDialog::_finish_async(int64_t request_id) {
+    if (!_async_request || _async_request->id != request_id) {
+        return;  // 已取消或已完成
+    }
+    std::shared_ptr<AsyncRequest> request = _async_request;
+    _async_request.reset();
+
+    PackedStringArray paths;
+    _result_truncated = false;
+    if (!request->cancelled.load(std::memory_order_acquire)) {
+        paths = _parse_result_paths(request->result);
+        _result_truncated = request->truncated;
+    }
+
+    // 先持有引用再释放_async_self，保证信号发出期间对象存活
+    Ref<UniWinFileDialog> self = _async_self;
+    _async_self.unref();
+    emit_signal("dialog_completed", paths, request_id);
+}
+
+bool UniWinFileDialog::_acquire_panel(int64_t window_id) {
+    std::lock_guard<std::mutex> lock(g_panel_mutex);
+    return g_open_panel_windows.insert(window_id).second;
+}
+
+void UniWinFileDialog::_release_panel(int64_t window_id) {
+    std::lock_guard<std::mutex> lock(g_panel_mutex);
+    g_open_panel_windows.erase(window_id);
+}
+
 void UniWinFileDialog::_set_flag(DialogFlag flag, bool value) {
-    if (value) {
-        _flags |= flag;
-    } else {
-        _flags &= ~flag;
+    int flags = value ? (_flags | flag) : (_flags & ~flag);
+    if (flags != _flags) {
+        _flags = flags;
+        _invalidate_settings();
     }
 }
 
@@ -4,6 +4,8 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/packed_string_array.hpp>
+#include "uniwinc_core.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 
@@ -34,6 +36,8 @@ public:
     
     String to_string() const;
     static String join_filters(const std::vector<FileFilter>& filters);
+    // 解析 ["标题", "ext1;ext2", ...] 格式的过滤器列表
+    static std::vector<FileFilter> parse_pairs(const PackedStringArray& pairs);
 };
 
 // 面板设置结构体 (对应Unity的PanelSettings)
@@ -67,6 +71,24 @@ private:
     String _default_extension;
     int _flags;
     DialogType _dialog_type;
+    int64_t _window_id;
+    bool _result_truncated;
+
+    // 编码后的设置缓存，属性变化时置空，下次打开时重建
+    std::shared_ptr<const CompiledPanelSettings> _compiled_settings;
+
+    // 异步对话框：工作线程只持有请求状态，结果通过call_deferred交回主线程
+    struct AsyncRequest {
+        int64_t id = 0;
+        int64_t window_id = 0;
+        DialogType type = OPEN_FILE;
+        std::shared_ptr<const CompiledPanelSettings> settings;
+        String result;
+        bool truncated = false;
+        std::atomic<bool> cancelled{false};
+    };
+    std::shared_ptr<AsyncRequest> _async_request;
+    Ref<UniWinFileDialog> _async_self;  // 面板打开期间保持自身存活，完成时释放
 
 protected:
     static void _bind_methods();
@@ -97,6 +119,10 @@ public:
     void set_dialog_type(DialogType type);
     DialogType get_dialog_type() const;
 
+    // 对话框所属的Godot窗口，同一窗口同时只允许一个面板
+    void set_window_id(int64_t window_id);
+    int64_t get_window_id() const;
+
     // 标志设置 (对应Unity的Flag)
     void set_file_must_exist(bool must_exist);
     bool get_file_must_exist() const;
@@ -128,6 +154,26 @@ public:
     String save_file_dialog();
     String open_directory_dialog();
 
+    // 异步对话框：面板关闭后发出dialog_completed信号
+    // 只有Windows在独立线程运行面板；macOS等平台要求在主线程打开面板，调用会阻塞到面板关闭
+    // 返回请求ID，窗口已有面板打开时返回0
+    int64_t open_file_dialog_async();
+    int64_t open_file_dialog_multiple_async();
+    int64_t save_file_dialog_async();
+    int64_t open_directory_dialog_async();
+
+    // 取消请求（0为当前请求）：native面板无法强制关闭，结果会被丢弃并以空路径完成
+    bool cancel_dialog(int64_t request_id = 0);
+    bool is_dialog_pending() const;
+    int64_t get_pending_request_id() const;
+    // 上一次结果是否写满了native缓冲区（路径列表可能不完整）
+    bool is_result_truncated() const;
+    static bool is_panel_open(int64_t window_id = 0);
+
+    // 多选结果缓冲区大小（字节），影响所有对话框
+    static void set_multi_select_buffer_size(int bytes);
+    static int get_multi_select_buffer_size();
+
     // 便捷的静态方法
     static String open_file(const String& title = "", const PackedStringArray& filters = PackedStringArray(), const String& default_path = "");
     static PackedStringArray open_files(const String& title = "", const PackedStringArray& filters = PackedStringArray(), const String& default_path = "");
@@ -135,9 +181,17 @@ public:
     static String open_directory(const String& title = "", const String& default_path = "");
 
 private:
-    PanelSettings _create_panel_settings() const;
+    std::shared_ptr<const CompiledPanelSettings> _get_compiled_settings();
+    void _invalidate_settings();
     PackedStringArray _parse_result_paths(const String& result) const;
     String _execute_dialog();
+    static String _run_dialog(DialogType type, const CompiledPanelSettings& settings, bool* truncated);
+    int64_t _start_async(DialogType type);
+    static void _async_main(std::shared_ptr<AsyncRequest> request, uint64_t owner_id);
+    static void _deliver_async_result(uint64_t owner_id, int64_t request_id);
+    void _finish_async(int64_t request_id);
+    static bool _acquire_panel(int64_t window_id);
+    static void _release_panel(int64_t window_id);
     void _set_flag(DialogFlag flag, bool value);
     bool _get_flag(DialogFlag flag) const;
 };
@@ -0,0 +1,472 @@
+#include "uniwinc_hit_tester.h"
+#include "uniwinc_controller.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/classes/display_server.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/rd_texture_format.hpp>
+#include <godot_cpp/classes/rd_texture_view.hpp>
+#include <godot_cpp/classes/rendering_device.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/viewport_texture.hpp>
+#include <godot_cpp/classes/window.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+using namespace godot;
+
+// 与uni_window_controller.gd中的枚举值保持一致
+static const int HIT_TEST_TYPE_NONE = 0;
+static const int HIT_TEST_TYPE_OPACITY = 1;
+static const int TRANSPARENT_TYPE_COLOR_KEY = 2;
+
+void UniWinHitTester::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_sample_radius", "radius"), &UniWinHitTester::set_sample_radius);
+    ClassDB::bind_method(D_METHOD("get_sample_radius"), &UniWinHitTester::get_sample_radius);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "sample_radius", PROPERTY_HINT_RANGE, "0,8"), "set_sample_radius", "get_sample_radius");
+
+    ClassDB::bind_method(D_METHOD("set_readback_latency", "frames"), &UniWinHitTester::set_readback_latency);
+    ClassDB::bind_method(D_METHOD("get_readback_latency"), &UniWinHitTester::get_readback_latency);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "readback_latency", PROPERTY_HINT_RANGE, "0,7"), "set_readback_latency", "get_readback_latency");
+
+    ClassDB::bind_method(D_METHOD("get_stalls_avoided"), &UniWinHitTester::get_stalls_avoided);
+    ClassDB::bind_method(D_METHOD("get_readbacks_submitted"), &UniWinHitTester::get_readbacks_submitted);
+    ClassDB::bind_method(D_METHOD("reset_readback_stats"), &UniWinHitTester::reset_readback_stats);
+
+    ClassDB::bind_method(D_METHOD("get_on_object"), &UniWinHitTester::get_on_object);
+    ClassDB::bind_method(D_METHOD("get_picked_color"), &UniWinHitTester::get_picked_color);
+
+    ClassDB::bind_method(D_METHOD("hit_test", "viewport", "opacity_threshold"), &UniWinHitTester::hit_test);
+    ClassDB::bind_method(D_METHOD("update", "viewport", "controller"), &UniWinHitTester::update);
+}
+
+UniWinHitTester::UniWinHitTester() {
+}
+
+UniWinHitTester::~UniWinHitTester() {
+    _free_staging_texture();
+}
+
+void UniWinHitTester::set_sample_radius(int radius) {
+    _sample_radius = Math::clamp(radius, 0, 8);
+}
+
+int UniWinHitTester::get_sample_radius() const {
+    return _sample_radius;
+}
+
+void UniWinHitTester::set_readback_latency(int frames) {
+    _readback_latency = Math::clamp(frames, 0, MAX_READBACK_RING_SIZE - 1);
+}
+
+int UniWinHitTester::get_readback_latency() const {
+    return _readback_latency;
+}
+
+int64_t UniWinHitTester::get_stalls_avoided() const {
+    return (int64_t)_stalls_avoided.load();
+}
+
+int64_t UniWinHitTester::get_readbacks_submitted() const {
+    return (int64_t)_readbacks_submitted.load();
+}
+
+void UniWinHitTester::reset_readback_stats() {
+    _stalls_avoided = 0;
+    _readbacks_submitted = 0;
+}
+
+bool UniWinHitTester::get_on_object() const {
+    return _on_object;
+}
+
+Color UniWinHitTester::get_picked_color() const {
+    return _picked_color;
+}
+
+bool UniWinHitTester::hit_test(Viewport* viewport, float opacity_threshold) {
+    if (!viewport) {
+        _on_object = false;
+        return _on_object;
+    }
+
+    // 检查鼠标是否在视口范围内
+    Vector2i cursor = _get_client_cursor_position(viewport);
+    Vector2 screen_size = viewport->get_visible_rect().size;
+    if (cursor.x < 0 || cursor.x >= screen_size.x || cursor.y < 0 || cursor.y >= screen_size.y) {
+        _on_object = false;
+        return _on_object;
+    }
+
+    Color center_color;
+    float max_alpha = 0.0f;
+    if (!_read_region(viewport, cursor, center_color, max_alpha)) {
+        _on_object = false;
+        return _on_object;
+    }
+
+    // 对应Unity版本：return (color.a >= opacityThreshold)
+    _picked_color = center_color;
+    _on_object = max_alpha >= opacity_threshold;
+    return _on_object;
+}
+
+bool UniWinHitTester::update(Viewport* viewport, UniWindowController* controller) {
+    if (!controller) {
+        return false;
+    }
+
+    // 自動ヒットテスト無しならば終了
+    if (!controller->get_hit_test_enabled() || controller->get_hit_test_type() == HIT_TEST_TYPE_NONE) {
+        _on_object = true;
+        return false;
+    }
+
+    if (controller->get_hit_test_type() != HIT_TEST_TYPE_OPACITY) {
+        // Raycast暂未实现，与GDScript版本一致视为命中
+        _on_object = true;
+    } else if (!controller->get_transparent() || controller->get_transparent_type() == TRANSPARENT_TYPE_COLOR_KEY) {
+        // 不透明窗口或ColorKey模式下，只要光标在窗口范围内就算命中
+        Vector2i cursor = _get_client_cursor_position(viewport);
+        Vector2 screen_size = viewport ? viewport->get_visible_rect().size : Vector2();
+        _on_object = cursor.x >= 0 && cursor.x < screen_size.x && cursor.y >= 0 && cursor.y < screen_size.y;
+    } else {
+        hit_test(viewport, controller->get_opacity_threshold());
+    }
+
+    // 对应Unity版本的UpdateClickThrough()
+    bool click_through = controller->get_clickthrough();
+    if (click_through) {
+        // ここまでクリックスルー状態だったら、ヒットしたときだけ戻す
+        if (_on_object) {
+            controller->set_clickthrough(false);
+            return true;
+        }
+    } else if (controller->get_transparent() && !_on_object) {
+        // 透明かつヒットしなかったときだけクリックスルーとする
+        controller->set_clickthrough(true);
+        return true;
+    }
+    return false;
+}
+
+Vector2i UniWinHitTester::_get_client_cursor_position(Viewport* viewport) const {
+    // 获取客户端相对鼠标位置，类似Unity版本的GetClientCursorPosition
+    if (!viewport) {
+        return Vector2i(-1, -1);
+    }
+    Window* window = viewport->get_window();
+    if (!window) {
+        return Vector2i(-1, -1);
+    }
+    return DisplayServer::get_singleton()->mouse_get_position() - window->get_position();
+}
+
+bool UniWinHitTester::_read_region(Viewport* viewport, const Vector2i& center, Color& r_center_color, float& r_max_alpha) {
+    Ref<ViewportTexture> viewport_texture = viewport->get_texture();
+    if (viewport_texture.is_null()) {
+        return false;
+    }
+
+    // 计算需要回读的区域（裁剪到纹理范围内）
+    Vector2i texture_size = Vector2i(viewport_texture->get_size());
+    Vector2i origin = Vector2i(
+        Math::clamp(center.x - _sample_radius, 0, texture_size.x),
+        Math::clamp(center.y - _sample_radius, 0, texture_size.y));
+    Vector2i end = Vector2i(
+        Math::clamp(center.x + _sample_radius + 1, 0, texture_size.x),
+        Math::clamp(center.y + _sample_radius + 1, 0, texture_size.y));
+    Vector2i extent = end - origin;
+    if (extent.x <= 0 || extent.y <= 0) {
+        return false;
+    }
+
+    RenderingServer* rs = RenderingServer::get_singleton();
+    RenderingDevice* rd = rs->get_rendering_device();
+    RID source_texture = rd ? rs->texture_get_rd_texture(viewport_texture->get_rid()) : RID();
+
+    // Compatibility渲染器无法访问RenderingDevice，退回整图读取
+    if (!rd || !source_texture.is_valid()) {
+        return _read_region_from_image(viewport, center, origin, extent, r_center_color, r_max_alpha);
+    }
+
+    if (_readback_latency > 0) {
+        return _read_region_async(rd, source_texture, center, origin, extent, r_center_color, r_max_alpha);
+    }
+
+    // 同步回读只能在渲染线程上进行；不使用回读环，沿用现有槽位数
+    if (!rs->is_on_render_thread()) {
+        return _read_region_from_image(viewport, center, origin, extent, r_center_color, r_max_alpha);
+    }
+    _rd = rd;
+    int staging_extent = _sample_radius * 2 + 1;
+    if (!_ensure_staging_texture(source_texture, staging_extent, _ring_size)) {
+        return _read_region_from_image(viewport, center, origin, extent, r_center_color, r_max_alpha);
+    }
+
+    // 只把光标附近的小块区域复制到中转纹理，再回读到CPU
+    Error err = rd->texture_copy(source_texture, _staging_texture,
+                                 Vector3(origin.x, origin.y, 0), Vector3(0, 0, 0), Vector3(extent.x, extent.y, 1),
+                                 0, 0, 0, 0);
+    if (err != OK) {
+        return _read_region_from_image(viewport, center, origin, extent, r_center_color, r_max_alpha);
+    }
+
+    PackedByteArray data = rd->texture_get_data(_staging_texture, 0);
+    return _decode_region(data, _source_format, _staging_extent, center, origin, extent, r_center_color, r_max_alpha);
+}
+
+bool UniWinHitTester::_read_region_async(RenderingDevice* rd, const RID& source_texture, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, Color& r_center_color, float& r_max_alpha) {
+    // 每个渲染帧只提交一次回读
+    int64_t frame = (int64_t)Engine::get_singleton()->get_frames_drawn();
+    if (frame != _ring_frame) {
+        _ring_frame = frame;
+        // 在途帧数内提交的复制可能还没在GPU上执行，读取前至少等待这么多帧
+        int frames_in_flight = (int)rd->get_frame_delay();
+        int latency = Math::clamp(MAX(_readback_latency, frames_in_flight), 1, MAX_READBACK_RING_SIZE - 1);
+        int staging_extent = _sample_radius * 2 + 1;
+        RenderingServer* rs = RenderingServer::get_singleton();
+        if (rs->is_on_render_thread()) {
+            _pump_ring(source_texture, center, origin, extent, frame, staging_extent, latency);
+        } else {
+            // 绑定的Ref保证对象在排队的回读执行完之前不会被释放
+            rs->call_on_render_thread(callable_mp_static(&UniWinHitTester::_pump_ring_queued).bind(Ref<UniWinHitTester>(this), source_texture, center, origin, extent, frame, staging_extent, latency));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_ring_mutex);
+    if (!_ring_has_result) {
+        // 回读环尚未产出结果，保持上一次的状态
+        r_center_color = _picked_color;
+        r_max_alpha = _on_object ? 1.0f : 0.0f;
+        return true;
+    }
+    r_center_color = _ring_center_color;
+    r_max_alpha = _ring_max_alpha;
+    return true;
+}
+
+void UniWinHitTester::_pump_ring_queued(const Ref<UniWinHitTester>& hit_tester, const RID& source_texture, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, int64_t frame, int staging_extent, int latency) {
+    if (hit_tester.is_valid()) {
+        hit_tester->_pump_ring(source_texture, center, origin, extent, frame, staging_extent, latency);
+    }
+}
+
+void UniWinHitTester::_pump_ring(const RID& source_texture, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, int64_t frame, int staging_extent, int latency) {
+    // 在渲染线程上执行：先取回latency帧之前提交的结果，再提交本帧的复制
+    _rd = RenderingServer::get_singleton()->get_rendering_device();
+    if (!_rd || !_ensure_staging_texture(source_texture, staging_extent, latency + 1)) {
+        return;
+    }
+
+    // 1. 取回最新的、已经过足够帧数的槽位。槽位纹理是CPU可读的，
+    //    读取时直接映射内存，不需要刷新命令队列等待GPU
+    int ready_index = -1;
+    for (int i = 0; i < _ring_size; i++) {
+        const ReadbackSlot& slot = _ring[i];
+        if (!slot.pending || (int64_t)slot.frame + latency > frame) {
+            continue;
+        }
+        if (ready_index < 0 || slot.frame > _ring[ready_index].frame) {
+            ready_index = i;
+        }
+    }
+    if (ready_index >= 0) {
+        ReadbackSlot& slot = _ring[ready_index];
+        PackedByteArray data = _rd->texture_get_data(slot.texture, 0);
+        Color center_color;
+        float max_alpha = 0.0f;
+        if (_decode_region(data, _source_format, _staging_extent, slot.center, slot.origin, slot.extent, center_color, max_alpha)) {
+            std::lock_guard<std::mutex> lock(_ring_mutex);
+            _ring_center_color = center_color;
+            _ring_max_alpha = max_alpha;
+            _ring_has_result = true;
+            _stalls_avoided++;
+        }
+        // 比已取回结果更旧的槽位直接丢弃
+        for (int i = 0; i < _ring_size; i++) {
+            if (_ring[i].pending && _ring[i].frame <= slot.frame) {
+                _ring[i].pending = false;
+            }
+        }
+    }
+
+    // 2. 把本帧光标附近的区域复制到写入槽位，只记录GPU命令，不等待
+    ReadbackSlot& write_slot = _ring[frame % _ring_size];
+    Error err = _rd->texture_copy(source_texture, write_slot.texture,
+                                  Vector3(origin.x, origin.y, 0), Vector3(0, 0, 0), Vector3(extent.x, extent.y, 1),
+                                  0, 0, 0, 0);
+    if (err != OK) {
+        write_slot.pending = false;
+        return;
+    }
+    write_slot.origin = origin;
+    write_slot.extent = extent;
+    write_slot.center = center;
+    write_slot.frame = frame;
+    write_slot.pending = true;
+    _readbacks_submitted++;
+}
+
+bool UniWinHitTester::_decode_region(const PackedByteArray& data, int64_t format, int row_pixels, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, Color& r_center_color, float& r_max_alpha) {
+    bool is_half_float = format == RenderingDevice::DATA_FORMAT_R16G16B16A16_SFLOAT;
+    bool is_bgra = format == RenderingDevice::DATA_FORMAT_B8G8R8A8_UNORM ||
+                   format == RenderingDevice::DATA_FORMAT_B8G8R8A8_SRGB;
+    int pixel_size = is_half_float ? 8 : 4;
+    if (data.size() < (int64_t)row_pixels * extent.y * pixel_size) {
+        return false;
+    }
+
+    const uint8_t* bytes = data.ptr();
+    r_max_alpha = 0.0f;
+    for (int y = 0; y < extent.y; y++) {
+        for (int x = 0; x < extent.x; x++) {
+            const uint8_t* px = bytes + ((int64_t)y * row_pixels + x) * pixel_size;
+            Color color;
+            if (is_half_float) {
+                const uint16_t* h = reinterpret_cast<const uint16_t*>(px);
+                color = Color(Math::half_to_float(h[0]), Math::half_to_float(h[1]),
+                              Math::half_to_float(h[2]), Math::half_to_float(h[3]));
+            } else if (is_bgra) {
+                color = Color(px[2] / 255.0f, px[1] / 255.0f, px[0] / 255.0f, px[3] / 255.0f);
+            } else {
+                color = Color(px[0] / 255.0f, px[1] / 255.0f, px[2] / 255.0f, px[3] / 255.0f);
+            }
+            r_max_alpha = MAX(r_max_alpha, color.a);
+            if (origin.x + x == center.x && origin.y + y == center.y) {
+                r_center_color = color;
+            }
+        }
+    }
+    return true;
+}
+
+bool UniWinHitTester::_read_region_from_image(Viewport* viewport, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, Color& r_center_color, float& r_max_alpha) {
+    // 退回方案：与原GDScript实现相同，读取整个视口图像
+    Ref<ViewportTexture> viewport_texture = viewport->get_texture();
+    if (viewport_texture.is_null()) {
+        return false;
+    }
+    Ref<Image> image = viewport_texture->get_image();
+    if (image.is_null()) {
+        return false;
+    }
+
+    r_max_alpha = 0.0f;
+    for (int y = origin.y; y < origin.y + extent.y; y++) {
+        for (int x = origin.x; x < origin.x + extent.x; x++) {
+            Color color = image->get_pixel(x, y);
+            r_max_alpha = MAX(r_max_alpha, color.a);
+            if (x == center.x && y == center.y) {
+                r_center_color = color;
+            }
+        }
+    }
+    return true;
+}
+
+RID UniWinHitTester::_create_readback_texture(int64_t format, int extent, bool cpu_readable) {
+    Ref<RDTextureFormat> texture_format;
+    texture_format.instantiate();
+    texture_format->set_format((RenderingDevice::DataFormat)format);
+    texture_format->set_width(extent);
+    texture_format->set_height(extent);
+    int64_t usage = RenderingDevice::TEXTURE_USAGE_CAN_COPY_TO_BIT | RenderingDevice::TEXTURE_USAGE_CAN_COPY_FROM_BIT;
+    if (cpu_readable) {
+        // CPU可读纹理位于主机可见内存中，texture_get_data不会阻塞渲染线程
+        usage |= RenderingDevice::TEXTURE_USAGE_CPU_READ_BIT;
+    }
+    texture_format->set_usage_bits(usage);
+
+    Ref<RDTextureView> view;
+    view.instantiate();
+    return _rd->texture_create(texture_format, view);
+}
+
+bool UniWinHitTester::_ensure_staging_texture(const RID& source_texture, int extent, int ring_size) {
+    ring_size = Math::clamp(ring_size, 1, MAX_READBACK_RING_SIZE);
+    if (_staging_texture.is_valid() && source_texture == _source_texture && extent == _staging_extent && ring_size == _ring_size) {
+        return true;
+    }
+
+    // 视口纹理重建（窗口大小变化等）或采样半径变化时重新创建中转纹理
+    Ref<RDTextureFormat> source_format = _rd->texture_get_format(source_texture);
+    if (source_format.is_null()) {
+        return false;
+    }
+    int64_t format = source_format->get_format();
+    if (format != RenderingDevice::DATA_FORMAT_R8G8B8A8_UNORM &&
+        format != RenderingDevice::DATA_FORMAT_R8G8B8A8_SRGB &&
+        format != RenderingDevice::DATA_FORMAT_B8G8R8A8_UNORM &&
+        format != RenderingDevice::DATA_FORMAT_B8G8R8A8_SRGB &&
+        format != RenderingDevice::DATA_FORMAT_R16G16B16A16_SFLOAT) {
+        return false;
+    }
+
+    if (_staging_texture.is_valid() && format == _source_format && extent == _staging_extent && ring_size == _ring_size) {
+        _source_texture = source_texture;
+        return true;
+    }
+
+    RenderingDevice* rd = _rd;
+    _free_staging_texture();
+    _rd = rd;
+
+    _staging_texture = _create_readback_texture(format, extent, false);
+    if (!_staging_texture.is_valid()) {
+        return false;
+    }
+    for (int i = 0; i < ring_size; i++) {
+        _ring[i] = ReadbackSlot();
+        _ring[i].texture = _create_readback_texture(format, extent, true);
+        if (!_ring[i].texture.is_valid()) {
+            _free_staging_texture();
+            _rd = rd;
+            return false;
+        }
+    }
+    _source_texture = source_texture;
+    _source_format = format;
+    _staging_extent = extent;
+    _ring_size = ring_size;
+    return true;
+}
+
+void UniWinHitTester::_free_staging_texture() {
+    Array rids;
+    if (_staging_texture.is_valid()) {
+        rids.append(_staging_texture);
+    }
+    for (int i = 0; i < MAX_READBACK_RING_SIZE; i++) {
+        if (_ring[i].texture.is_valid()) {
+            rids.append(_ring[i].texture);
+        }
+        _ring[i] = ReadbackSlot();
+    }
+    // RD资源只能在渲染线程上释放；析构可能发生在主线程，此时交给渲染线程
+    RenderingServer* rs = RenderingServer::get_singleton();
+    if (_rd && !rids.is_empty() && rs) {
+        if (rs->is_on_render_thread()) {
+            _free_rids(rids);
+        } else {
+            rs->call_on_render_thread(callable_mp_static(&UniWinHitTester::_free_rids).bind(rids));
+        }
+    }
+    _staging_texture = RID();
+    _source_texture = RID();
+    _source_format = -1;
+    _staging_extent = 0;
+    _ring_size = 0;
+    _rd = nullptr;
+}
+
+void UniWinHitTester::_free_rids(const Array& rids) {
+    RenderingDevice* rd = RenderingServer::get_singleton()->get_rendering_device();
+    if (!rd) {
+        return;
+    }
+    for (int i = 0; i < rids.size(); i++) {
+        rd->free_rid(rids[i]);
+    }
+}
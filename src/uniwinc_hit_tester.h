@@ -0,0 +1,112 @@
+#ifndef UNIWINC_HIT_TESTER_H
+#define UNIWINC_HIT_TESTER_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/color.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/rid.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace godot {
+class RenderingDevice;
+}
+
+using namespace godot;
+
+class UniWindowController;
+
+// 基于像素不透明度的点击测试器 (对应Unity的HitTestByOpaquePixel)
+// 只回读光标附近的一小块区域，而不是整个视口图像
+class UniWinHitTester : public RefCounted {
+    GDCLASS(UniWinHitTester, RefCounted)
+
+public:
+    // 回读环的最大槽位数。实际使用的槽位数为 延迟 + 1，
+    // 延迟不小于RenderingDevice同时在途的帧数（get_frame_delay），保证读取时复制命令已执行完毕
+    static const int MAX_READBACK_RING_SIZE = 8;
+
+private:
+    // 异步回读环中的一个槽位
+    struct ReadbackSlot {
+        RID texture;
+        Vector2i origin;
+        Vector2i extent;
+        Vector2i center;
+        uint64_t frame = 0;
+        bool pending = false;
+    };
+
+    int _sample_radius = 0;  // 采样半径，0表示只读取光标下的单个像素
+    int _readback_latency = 2;  // 0为同步回读，>0为使用N帧前提交的回读结果（至少为在途帧数）
+    bool _on_object = true;
+    Color _picked_color = Color(1.0f, 1.0f, 1.0f, 1.0f);
+
+    // 回读用的小尺寸中转纹理（RenderingDevice资源）
+    // 以下状态只在渲染线程上访问；主线程的设置（采样半径、延迟）作为参数传入
+    // 排队中的_pump_ring持有对象的引用，析构时RD资源交给渲染线程释放
+    RenderingDevice* _rd = nullptr;
+    RID _staging_texture;
+    RID _source_texture;      // 上一次使用的视口RD纹理
+    int64_t _source_format = -1;
+    int _staging_extent = 0;
+
+    // 异步回读环（可能在渲染线程上推进）
+    ReadbackSlot _ring[MAX_READBACK_RING_SIZE];
+    int _ring_size = 0;
+    int64_t _ring_frame = -1;  // 最近一次提交回读的渲染帧号
+    std::mutex _ring_mutex;
+    bool _ring_has_result = false;
+    Color _ring_center_color;
+    float _ring_max_alpha = 0.0f;
+    std::atomic<uint64_t> _stalls_avoided{0};
+    std::atomic<uint64_t> _readbacks_submitted{0};
+
+protected:
+    static void _bind_methods();
+
+public:
+    UniWinHitTester();
+    ~UniWinHitTester();
+
+    void set_sample_radius(int radius);
+    int get_sample_radius() const;
+
+    void set_readback_latency(int frames);
+    int get_readback_latency() const;
+
+    bool get_on_object() const;
+    Color get_picked_color() const;
+
+    // 回读环统计：避免的同步等待帧数和已提交的回读数
+    int64_t get_stalls_avoided() const;
+    int64_t get_readbacks_submitted() const;
+    void reset_readback_stats();
+
+    // 检测光标下是否有不透明像素，只更新on_object/picked_color
+    bool hit_test(Viewport* viewport, float opacity_threshold);
+
+    // 执行一次完整的点击测试并直接更新控制器的点击透传状态
+    // 返回值表示点击透传状态是否发生了变化
+    bool update(Viewport* viewport, UniWindowController* controller);
+
+private:
+    Vector2i _get_client_cursor_position(Viewport* viewport) const;
+    bool _read_region(Viewport* viewport, const Vector2i& center, Color& r_center_color, float& r_max_alpha);
+    bool _read_region_from_image(Viewport* viewport, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, Color& r_center_color, float& r_max_alpha);
+    bool _read_region_async(RenderingDevice* rd, const RID& source_texture, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, Color& r_center_color, float& r_max_alpha);
+    static void _pump_ring_queued(const Ref<UniWinHitTester>& hit_tester, const RID& source_texture, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, int64_t frame, int staging_extent, int latency);
+    void _pump_ring(const RID& source_texture, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, int64_t frame, int staging_extent, int latency);
+    static bool _decode_region(const PackedByteArray& data, int64_t format, int row_pixels, const Vector2i& center, const Vector2i& origin, const Vector2i& extent, Color& r_center_color, float& r_max_alpha);
+    RID _create_readback_texture(int64_t format, int extent, bool cpu_readable);
+    bool _ensure_staging_texture(const RID& source_texture, int extent, int ring_size);
+    void _free_staging_texture();
+    static void _free_rids(const Array& rids);
+};
+
+#endif // UNIWINC_HIT_TESTER_H
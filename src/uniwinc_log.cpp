@@ -0,0 +1,68 @@
+#include "uniwinc_log.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+using namespace godot;
+
+// 默认不输出DEBUG级别，需要时在脚本中调用 UniWinLog.set_level(UniWinLog.LEVEL_DEBUG)
+std::atomic<int> UniWinLog::_level(UniWinLog::LEVEL_INFO);
+std::atomic<uint32_t> UniWinLog::_category_mask(UniWinLog::CATEGORY_ALL);
+
+void UniWinLog::_bind_methods() {
+    BIND_ENUM_CONSTANT(LEVEL_NONE);
+    BIND_ENUM_CONSTANT(LEVEL_ERROR);
+    BIND_ENUM_CONSTANT(LEVEL_WARNING);
+    BIND_ENUM_CONSTANT(LEVEL_INFO);
+    BIND_ENUM_CONSTANT(LEVEL_DEBUG);
+
+    BIND_ENUM_CONSTANT(CATEGORY_CORE);
+    BIND_ENUM_CONSTANT(CATEGORY_WINDOW);
+    BIND_ENUM_CONSTANT(CATEGORY_DROP);
+    BIND_ENUM_CONSTANT(CATEGORY_MONITOR);
+    BIND_ENUM_CONSTANT(CATEGORY_DIALOG);
+    BIND_ENUM_CONSTANT(CATEGORY_INPUT);
+    BIND_ENUM_CONSTANT(CATEGORY_HIT_TEST);
+    BIND_ENUM_CONSTANT(CATEGORY_ALL);
+
+    ClassDB::bind_static_method("UniWinLog", D_METHOD("set_level", "level"), &UniWinLog::set_level);
+    ClassDB::bind_static_method("UniWinLog", D_METHOD("get_level"), &UniWinLog::get_level);
+    ClassDB::bind_static_method("UniWinLog", D_METHOD("set_category_mask", "mask"), &UniWinLog::set_category_mask);
+    ClassDB::bind_static_method("UniWinLog", D_METHOD("get_category_mask"), &UniWinLog::get_category_mask);
+    ClassDB::bind_static_method("UniWinLog", D_METHOD("get_compiled_level"), &UniWinLog::get_compiled_level);
+}
+
+void UniWinLog::write(int level, uint32_t category, const String& message) {
+    String line = "[UniWinC] " + message;
+    switch (level) {
+        case LEVEL_ERROR:
+            UtilityFunctions::push_error(line);
+            break;
+        case LEVEL_WARNING:
+            UtilityFunctions::push_warning(line);
+            break;
+        default:
+            UtilityFunctions::print(line);
+            break;
+    }
+}
+
+void UniWinLog::set_level(int level) {
+    _level.store(level, std::memory_order_relaxed);
+}
+
+int UniWinLog::get_level() {
+    return _level.load(std::memory_order_relaxed);
+}
+
+void UniWinLog::set_category_mask(int mask) {
+    _category_mask.store((uint32_t)mask, std::memory_order_relaxed);
+}
+
+int UniWinLog::get_category_mask() {
+    return (int)_category_mask.load(std::memory_order_relaxed);
+}
+
+int UniWinLog::get_compiled_level() {
+    return UNIWINC_LOG_LEVEL;
+}
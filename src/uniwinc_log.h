@@ -0,0 +1,111 @@
+#ifndef UNIWINC_LOG_H
+#define UNIWINC_LOG_H
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+using namespace godot;
+
+// 编译期日志级别（数值需与UniWinLog::Level一致，供#if使用）
+#define UNIWINC_LOG_LEVEL_NONE 0
+#define UNIWINC_LOG_LEVEL_ERROR 1
+#define UNIWINC_LOG_LEVEL_WARNING 2
+#define UNIWINC_LOG_LEVEL_INFO 3
+#define UNIWINC_LOG_LEVEL_DEBUG 4
+
+// 未指定时：debug/editor构建保留全部日志，release构建只保留警告和错误
+// 可以通过 scons uniwinc_log_level=N 覆盖
+#ifndef UNIWINC_LOG_LEVEL
+#ifdef DEBUG_ENABLED
+#define UNIWINC_LOG_LEVEL UNIWINC_LOG_LEVEL_DEBUG
+#else
+#define UNIWINC_LOG_LEVEL UNIWINC_LOG_LEVEL_WARNING
+#endif
+#endif
+
+// 分级、分类的日志系统
+// 运行时通过级别和分类掩码过滤，被编译期级别排除的日志连字符串都不会构造
+class UniWinLog : public Object {
+    GDCLASS(UniWinLog, Object)
+
+public:
+    enum Level {
+        LEVEL_NONE = UNIWINC_LOG_LEVEL_NONE,
+        LEVEL_ERROR = UNIWINC_LOG_LEVEL_ERROR,
+        LEVEL_WARNING = UNIWINC_LOG_LEVEL_WARNING,
+        LEVEL_INFO = UNIWINC_LOG_LEVEL_INFO,
+        LEVEL_DEBUG = UNIWINC_LOG_LEVEL_DEBUG
+    };
+
+    enum Category {
+        CATEGORY_CORE = 1,      // 库加载和初始化
+        CATEGORY_WINDOW = 2,    // 窗口附加和状态
+        CATEGORY_DROP = 4,      // 文件拖放
+        CATEGORY_MONITOR = 8,   // 监视器适配
+        CATEGORY_DIALOG = 16,   // 文件对话框
+        CATEGORY_INPUT = 32,    // 鼠标和键盘
+        CATEGORY_HIT_TEST = 64, // 点击穿透判定
+        CATEGORY_ALL = 0xFFFF
+    };
+
+private:
+    static std::atomic<int> _level;
+    static std::atomic<uint32_t> _category_mask;
+
+protected:
+    static void _bind_methods();
+
+public:
+    static inline bool is_enabled(int level, uint32_t category) {
+        return level <= _level.load(std::memory_order_relaxed) &&
+               (category & _category_mask.load(std::memory_order_relaxed)) != 0;
+    }
+
+    static void write(int level, uint32_t category, const String& message);
+
+    // 运行时配置（脚本可调用）
+    static void set_level(int level);
+    static int get_level();
+    static void set_category_mask(int mask);
+    static int get_category_mask();
+    static int get_compiled_level();
+};
+
+VARIANT_ENUM_CAST(UniWinLog::Level);
+VARIANT_ENUM_CAST(UniWinLog::Category);
+
+#define UNIWINC_LOG(m_level, m_category, m_message)                     \
+    do {                                                                \
+        if (UniWinLog::is_enabled(m_level, m_category)) {               \
+            UniWinLog::write(m_level, m_category, m_message);           \
+        }                                                               \
+    } while (0)
+
+#if UNIWINC_LOG_LEVEL >= UNIWINC_LOG_LEVEL_ERROR
+#define UNIWINC_LOG_ERROR(m_category, m_message) UNIWINC_LOG(UniWinLog::LEVEL_ERROR, m_category, m_message)
+#else
+#define UNIWINC_LOG_ERROR(m_category, m_message) ((void)0)
+#endif
+
+#if UNIWINC_LOG_LEVEL >= UNIWINC_LOG_LEVEL_WARNING
+#define UNIWINC_LOG_WARNING(m_category, m_message) UNIWINC_LOG(UniWinLog::LEVEL_WARNING, m_category, m_message)
+#else
+#define UNIWINC_LOG_WARNING(m_category, m_message) ((void)0)
+#endif
+
+#if UNIWINC_LOG_LEVEL >= UNIWINC_LOG_LEVEL_INFO
+#define UNIWINC_LOG_INFO(m_category, m_message) UNIWINC_LOG(UniWinLog::LEVEL_INFO, m_category, m_message)
+#else
+#define UNIWINC_LOG_INFO(m_category, m_message) ((void)0)
+#endif
+
+#if UNIWINC_LOG_LEVEL >= UNIWINC_LOG_LEVEL_DEBUG
+#define UNIWINC_LOG_DEBUG(m_category, m_message) UNIWINC_LOG(UniWinLog::LEVEL_DEBUG, m_category, m_message)
+#else
+#define UNIWINC_LOG_DEBUG(m_category, m_message) ((void)0)
+#endif
+
+#endif // UNIWINC_LOG_H
@@ -0,0 +1,84 @@
+#include "uniwinc_motion_predictor.h"
+
+using namespace godot;
+
+void UniWinMotionPredictor::reset() {
+    _count = 0;
+    _head = 0;
+    _last_poll_time = 0.0;
+}
+
+void UniWinMotionPredictor::add_sample(const Vector2& position, double time) {
+    _last_poll_time = time;
+    if (_count > 0) {
+        // 高频轮询时两次采样之间光标常常还没动，重复采样会让速度忽大忽小
+        if (position == _at(0).position) {
+            return;
+        }
+        // 停顿后重新开始移动：停顿前的历史已不能反映当前运动
+        if (time - _at(0).time >= STOP_THRESHOLD) {
+            reset();
+            _last_poll_time = time;
+        }
+    }
+    _history[_head].position = position;
+    _history[_head].time = time;
+    _head = (_head + 1) % HISTORY_SIZE;
+    if (_count < HISTORY_SIZE) {
+        _count++;
+    }
+}
+
+const UniWinMotionPredictor::Sample& UniWinMotionPredictor::_at(int age) const {
+    return _history[(_head - 1 - age + HISTORY_SIZE * 2) % HISTORY_SIZE];
+}
+
+Vector2 UniWinMotionPredictor::_velocity(const Sample& from, const Sample& to) {
+    double dt = to.time - from.time;
+    if (dt <= 0.0) {
+        return Vector2();
+    }
+    return (to.position - from.position) / (float)dt;
+}
+
+Vector2 UniWinMotionPredictor::predict(double horizon, float max_distance, bool use_acceleration) const {
+    if (_count == 0) {
+        return Vector2();
+    }
+    const Sample& latest = _at(0);
+    if (_count < 3 || horizon <= 0.0 || max_distance <= 0.0f) {
+        return latest.position;
+    }
+
+    // 光标已停下：不外推，窗口立即对齐实际位置
+    if (_last_poll_time - latest.time >= STOP_THRESHOLD) {
+        return latest.position;
+    }
+
+    // 历史分成新旧两半，各自求平均速度，速度差除以两段中点的时间差得到加速度
+    int half = _count / 2;
+    const Sample& middle = _at(half);
+    const Sample& oldest = _at(_count - 1);
+    Vector2 recent_velocity = _velocity(middle, latest);
+    Vector2 velocity = recent_velocity;
+    Vector2 offset = velocity * (float)horizon;
+
+    if (use_acceleration) {
+        Vector2 older_velocity = _velocity(oldest, middle);
+        double span = (latest.time - oldest.time) * 0.5;
+        if (span > 0.0) {
+            Vector2 acceleration = (recent_velocity - older_velocity) / (float)span;
+            Vector2 accelerated = offset + acceleration * (float)(0.5 * horizon * horizon);
+            // 减速时加速度项不允许把预测推到运动方向的反面
+            if (accelerated.dot(velocity) > 0.0f) {
+                offset = accelerated;
+            }
+        }
+    }
+
+    float length = offset.length();
+    if (length > max_distance) {
+        offset *= max_distance / length;
+    }
+    return latest.position + offset;
+}
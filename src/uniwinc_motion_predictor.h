@@ -0,0 +1,42 @@
+#ifndef UNIWINC_MOTION_PREDICTOR_H
+#define UNIWINC_MOTION_PREDICTOR_H
+
+#include <godot_cpp/variant/vector2.hpp>
+
+#include <cstdint>
+
+using namespace godot;
+
+// 光标运动预测 - 根据最近几次采样估计速度和加速度，向前外推horizon秒
+// 外推位移限制在max_distance以内，光标停下时立即回到实际位置，避免过冲
+class UniWinMotionPredictor {
+public:
+    static const int HISTORY_SIZE = 8;
+    // 光标超过这么久没有移动才视为停下（约为240Hz轮询的7个周期、60Hz的2个周期）
+    static constexpr double STOP_THRESHOLD = 0.03;
+
+private:
+    struct Sample {
+        Vector2 position;
+        double time = 0.0;  // 秒
+    };
+
+    Sample _history[HISTORY_SIZE];
+    int _count = 0;
+    int _head = 0;  // 下一个写入位置
+    double _last_poll_time = 0.0;  // 最近一次add_sample的时间（包括位置未变的采样）
+
+public:
+    void reset();
+    // 位置与上一次相同的采样不进入历史，只更新轮询时间
+    void add_sample(const Vector2& position, double time);
+
+    // horizon为外推的秒数，use_acceleration为false时只按速度外推
+    Vector2 predict(double horizon, float max_distance, bool use_acceleration = true) const;
+
+private:
+    const Sample& _at(int age) const;  // age=0为最新采样
+    static Vector2 _velocity(const Sample& from, const Sample& to);
+};
+
+#endif // UNIWINC_MOTION_PREDICTOR_H
@@ -0,0 +1,68 @@
+#ifndef UNIWINC_MPSC_QUEUE_H
+#define UNIWINC_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 多生产者/单消费者有界无锁队列（Vyukov算法）
+// push可在任意线程并发调用，pop只能在一个线程调用；Capacity必须是2的幂
+template <typename T, size_t Capacity>
+class UniWinMpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    Cell _cells[Capacity];
+    alignas(64) std::atomic<size_t> _enqueue_pos{0};
+    alignas(64) std::atomic<size_t> _dequeue_pos{0};
+
+public:
+    UniWinMpscQueue() {
+        for (size_t i = 0; i < Capacity; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T& item) {
+        Cell* cell;
+        size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &_cells[pos & (Capacity - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0) {
+                // 槽位空闲，抢占写入位置
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // 队列已满
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell = &_cells[pos & (Capacity - 1)];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if ((intptr_t)sequence - (intptr_t)(pos + 1) < 0) {
+            return false;  // 队列为空（或生产者尚未写完）
+        }
+        item = cell->data;
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        _dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+#endif // UNIWINC_MPSC_QUEUE_H
@@ -0,0 +1,108 @@
+#include "uniwinc_path_list.h"
+
+#include <cwchar>
+
+using namespace godot;
+
+UniWinPathListParser::UniWinPathListParser(const wchar_t* text, int64_t length) {
+    if (!text) {
+        return;
+    }
+    _cursor = text;
+    _end = text + (length >= 0 ? (size_t)length : wcslen(text));
+}
+
+int64_t UniWinPathListParser::count_segments() const {
+    if (_cursor == _end) {
+        return 0;
+    }
+    int64_t count = 1;
+    for (const wchar_t* p = _cursor; p < _end; p++) {
+        if (*p == L'\n') {
+            count++;
+        }
+    }
+    return count;
+}
+
+int64_t UniWinPathListParser::parse(PackedStringArray& out, int64_t* index, int64_t max_paths) {
+    int64_t parsed = 0;
+    String* dst = out.ptrw();
+    int64_t capacity = out.size();
+
+    while (_cursor < _end && (max_paths < 0 || parsed < max_paths)) {
+        const wchar_t* line_end = _cursor;
+        while (line_end < _end && *line_end != L'\n') {
+            line_end++;
+        }
+
+        // 与String::strip_edges一致：去掉首尾的空白和控制字符（包括\r）
+        const wchar_t* begin = _cursor;
+        const wchar_t* end = line_end;
+        while (begin < end && (uint32_t)*begin <= 32) {
+            begin++;
+        }
+        while (end > begin && (uint32_t)end[-1] <= 32) {
+            end--;
+        }
+
+        _cursor = line_end < _end ? line_end + 1 : _end;
+
+        if (begin == end) {
+            continue;
+        }
+        if (*index >= capacity) {
+            break;  // 调用方预分配不足
+        }
+        dst[(*index)++] = _decode(begin, end);
+        parsed++;
+    }
+    return parsed;
+}
+
+bool UniWinPathListParser::is_done() const {
+    return _cursor >= _end;
+}
+
+PackedStringArray UniWinPathListParser::parse_all(const wchar_t* text, int64_t length) {
+    UniWinPathListParser parser(text, length);
+    PackedStringArray files;
+    files.resize(parser.count_segments());
+    int64_t count = 0;
+    parser.parse(files, &count);
+    files.resize(count);
+    return files;
+}
+
+String UniWinPathListParser::_decode(const wchar_t* begin, const wchar_t* end) {
+    int64_t length = end - begin;
+    String result;
+    result.resize(length + 1);
+    char32_t* dst = result.ptrw();
+    int64_t written = 0;
+
+    if (sizeof(wchar_t) == 2) {
+        // UTF-16：合并代理对，孤立的代理项替换为U+FFFD
+        for (const wchar_t* p = begin; p < end; p++) {
+            uint32_t c = (uint16_t)*p;
+            if (c >= 0xD800 && c <= 0xDBFF && p + 1 < end && (uint16_t)p[1] >= 0xDC00 && (uint16_t)p[1] <= 0xDFFF) {
+                c = 0x10000 + ((c - 0xD800) << 10) + ((uint16_t)p[1] - 0xDC00);
+                p++;
+            } else if (c >= 0xD800 && c <= 0xDFFF) {
+                c = 0xFFFD;
+            }
+            dst[written++] = (char32_t)c;
+        }
+    } else {
+        // UTF-32：直接复制
+        for (const wchar_t* p = begin; p < end; p++) {
+            dst[written++] = (char32_t)*p;
+        }
+    }
+
+    dst[written] = 0;
+    if (written < length) {
+        result.resize(written + 1);
+    }
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef UNIWINC_PATH_LIST_H
+#define UNIWINC_PATH_LIST_H
+
+#include <godot_cpp/variant/packed_string_array.hpp>
+
+#include <cstdint>
+
+using namespace godot;
+
+// 换行分隔的宽字符路径列表解析器（native拖放回调的格式）
+// 单次扫描，直接解码到Godot字符串：wchar_t为2字节时按UTF-16处理代理对，否则按UTF-32处理
+// 可以分多次调用parse()，每次最多解析max_paths个路径，用于把大量文件分到多帧处理
+class UniWinPathListParser {
+private:
+    const wchar_t* _cursor = nullptr;
+    const wchar_t* _end = nullptr;
+
+public:
+    UniWinPathListParser(const wchar_t* text, int64_t length = -1);
+
+    // 路径数量的上限（按分隔符计数，包含空行），用于预分配
+    int64_t count_segments() const;
+
+    // 解析下一批路径追加到out[*index]之后（out需预先分配足够大小），返回本次解析的数量
+    int64_t parse(PackedStringArray& out, int64_t* index, int64_t max_paths = -1);
+
+    bool is_done() const;
+
+    // 一次性解析全部路径
+    static PackedStringArray parse_all(const wchar_t* text, int64_t length = -1);
+
+private:
+    static String _decode(const wchar_t* begin, const wchar_t* end);
+};
+
+#endif // UNIWINC_PATH_LIST_H
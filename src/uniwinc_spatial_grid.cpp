@@ -0,0 +1,172 @@
+#include "uniwinc_spatial_grid.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/math.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+void UniWinSpatialGrid::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_cell_size", "size"), &UniWinSpatialGrid::set_cell_size);
+    ClassDB::bind_method(D_METHOD("get_cell_size"), &UniWinSpatialGrid::get_cell_size);
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cell_size", PROPERTY_HINT_RANGE, "8,4096"), "set_cell_size", "get_cell_size");
+
+    ClassDB::bind_method(D_METHOD("update_item", "id", "rect", "z_index", "order"), &UniWinSpatialGrid::update_item);
+    ClassDB::bind_method(D_METHOD("remove_item", "id"), &UniWinSpatialGrid::remove_item);
+    ClassDB::bind_method(D_METHOD("has_item", "id"), &UniWinSpatialGrid::has_item);
+    ClassDB::bind_method(D_METHOD("clear"), &UniWinSpatialGrid::clear);
+    ClassDB::bind_method(D_METHOD("query_point", "point"), &UniWinSpatialGrid::query_point);
+    ClassDB::bind_method(D_METHOD("get_item_count"), &UniWinSpatialGrid::get_item_count);
+}
+
+UniWinSpatialGrid::UniWinSpatialGrid() {
+}
+
+UniWinSpatialGrid::~UniWinSpatialGrid() {
+}
+
+void UniWinSpatialGrid::set_cell_size(float size) {
+    size = MAX(size, 8.0f);
+    if (size == _cell_size) {
+        return;
+    }
+    _cell_size = size;
+
+    // 单元大小变化，所有条目重新分配单元
+    _cells.clear();
+    for (auto& entry : _items) {
+        entry.second.cells = _get_cell_range(entry.second.rect);
+        _insert_cells(entry.first, entry.second.cells);
+    }
+}
+
+float UniWinSpatialGrid::get_cell_size() const {
+    return _cell_size;
+}
+
+void UniWinSpatialGrid::update_item(int64_t id, const Rect2& rect, int z_index, int order) {
+    CellRange range = _get_cell_range(rect);
+
+    auto it = _items.find(id);
+    if (it == _items.end()) {
+        Item item;
+        item.rect = rect;
+        item.z_index = z_index;
+        item.order = order;
+        item.cells = range;
+        _items.emplace(id, item);
+        _insert_cells(id, range);
+        return;
+    }
+
+    Item& item = it->second;
+    item.rect = rect;
+    item.z_index = z_index;
+    item.order = order;
+    if (item.cells == range) {
+        return;
+    }
+    _remove_cells(id, item.cells);
+    _insert_cells(id, range);
+    item.cells = range;
+}
+
+void UniWinSpatialGrid::remove_item(int64_t id) {
+    auto it = _items.find(id);
+    if (it == _items.end()) {
+        return;
+    }
+    _remove_cells(id, it->second.cells);
+    _items.erase(it);
+}
+
+bool UniWinSpatialGrid::has_item(int64_t id) const {
+    return _items.find(id) != _items.end();
+}
+
+void UniWinSpatialGrid::clear() {
+    _items.clear();
+    _cells.clear();
+}
+
+PackedInt64Array UniWinSpatialGrid::query_point(const Vector2& point) const {
+    PackedInt64Array result;
+
+    int cx = (int)Math::floor(point.x / _cell_size);
+    int cy = (int)Math::floor(point.y / _cell_size);
+    auto cell = _cells.find(_make_cell_key(cx, cy));
+    if (cell == _cells.end()) {
+        return result;
+    }
+
+    std::vector<const std::pair<const int64_t, Item>*> hits;
+    for (int64_t id : cell->second) {
+        auto it = _items.find(id);
+        if (it != _items.end() && it->second.rect.has_point(point)) {
+            hits.push_back(&*it);
+        }
+    }
+
+    // 与ObjectDragManager._compare_drag_handles相同的优先级
+    std::sort(hits.begin(), hits.end(), [](const std::pair<const int64_t, Item>* a, const std::pair<const int64_t, Item>* b) {
+        if (a->second.z_index != b->second.z_index) {
+            return a->second.z_index > b->second.z_index;
+        }
+        return a->second.order > b->second.order;
+    });
+
+    result.resize(hits.size());
+    for (size_t i = 0; i < hits.size(); i++) {
+        result.set(i, hits[i]->first);
+    }
+    return result;
+}
+
+int UniWinSpatialGrid::get_item_count() const {
+    return (int)_items.size();
+}
+
+UniWinSpatialGrid::CellRange UniWinSpatialGrid::_get_cell_range(const Rect2& rect) const {
+    CellRange range;
+    if (rect.size.x <= 0 || rect.size.y <= 0) {
+        return range;  // 空区域不占用任何单元
+    }
+    range.x0 = (int)Math::floor(rect.position.x / _cell_size);
+    range.y0 = (int)Math::floor(rect.position.y / _cell_size);
+    range.x1 = (int)Math::floor((rect.position.x + rect.size.x) / _cell_size);
+    range.y1 = (int)Math::floor((rect.position.y + rect.size.y) / _cell_size);
+    return range;
+}
+
+int64_t UniWinSpatialGrid::_make_cell_key(int x, int y) {
+    return ((int64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+void UniWinSpatialGrid::_insert_cells(int64_t id, const CellRange& range) {
+    for (int y = range.y0; y <= range.y1; y++) {
+        for (int x = range.x0; x <= range.x1; x++) {
+            _cells[_make_cell_key(x, y)].push_back(id);
+        }
+    }
+}
+
+void UniWinSpatialGrid::_remove_cells(int64_t id, const CellRange& range) {
+    for (int y = range.y0; y <= range.y1; y++) {
+        for (int x = range.x0; x <= range.x1; x++) {
+            auto cell = _cells.find(_make_cell_key(x, y));
+            if (cell == _cells.end()) {
+                continue;
+            }
+            std::vector<int64_t>& ids = cell->second;
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end()) {
+                *it = ids.back();
+                ids.pop_back();
+            }
+            if (ids.empty()) {
+                _cells.erase(cell);
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef UNIWINC_SPATIAL_GRID_H
+#define UNIWINC_SPATIAL_GRID_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+#include <godot_cpp/variant/vector2.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+using namespace godot;
+
+// 均匀网格空间索引 - 供ObjectDragManager按位置查找候选ObjectDragHandle
+// 结果按优先级排序：Z-index高的优先，场景树中靠后的优先
+class UniWinSpatialGrid : public RefCounted {
+    GDCLASS(UniWinSpatialGrid, RefCounted)
+
+private:
+    struct CellRange {
+        int x0 = 0;
+        int y0 = 0;
+        int x1 = -1;
+        int y1 = -1;
+
+        bool operator==(const CellRange& other) const {
+            return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+        }
+    };
+
+    struct Item {
+        Rect2 rect;
+        int z_index = 0;
+        int order = 0;
+        CellRange cells;
+    };
+
+    float _cell_size = 128.0f;
+    std::unordered_map<int64_t, Item> _items;
+    std::unordered_map<int64_t, std::vector<int64_t>> _cells;
+
+protected:
+    static void _bind_methods();
+
+public:
+    UniWinSpatialGrid();
+    ~UniWinSpatialGrid();
+
+    // 修改单元大小会重建整个索引
+    void set_cell_size(float size);
+    float get_cell_size() const;
+
+    // 插入或更新条目，只有覆盖的单元变化时才会移动条目
+    void update_item(int64_t id, const Rect2& rect, int z_index, int order);
+    void remove_item(int64_t id);
+    bool has_item(int64_t id) const;
+    void clear();
+
+    // 返回包含该点的条目ID，按优先级从高到低排序
+    PackedInt64Array query_point(const Vector2& point) const;
+
+    int get_item_count() const;
+
+private:
+    CellRange _get_cell_range(const Rect2& rect) const;
+    static int64_t _make_cell_key(int x, int y);
+    void _insert_cells(int64_t id, const CellRange& range);
+    void _remove_cells(int64_t id, const CellRange& range);
+};
+
+#endif // UNIWINC_SPATIAL_GRID_H
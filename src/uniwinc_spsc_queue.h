@@ -0,0 +1,45 @@
+#ifndef UNIWINC_SPSC_QUEUE_H
+#define UNIWINC_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// 单生产者/单消费者无锁环形队列
+// push只能在一个线程调用，pop只能在另一个线程调用；Capacity必须是2的幂
+template <typename T, size_t Capacity>
+class UniWinSpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    T _items[Capacity];
+    // 读写索引放在不同缓存行，避免生产者和消费者互相干扰
+    alignas(64) std::atomic<size_t> _head{0};  // 消费者写
+    alignas(64) std::atomic<size_t> _tail{0};  // 生产者写
+
+public:
+    bool push(const T& item) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) >= Capacity) {
+            return false;  // 队列已满
+        }
+        _items[tail & (Capacity - 1)] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;  // 队列为空
+        }
+        item = _items[head & (Capacity - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool is_empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif // UNIWINC_SPSC_QUEUE_H
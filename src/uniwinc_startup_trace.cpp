@@ -0,0 +1,173 @@
+#include "uniwinc_startup_trace.h"
+
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/variant/array.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace godot;
+
+std::mutex UniWinStartupTrace::_mutex;
+std::vector<UniWinStartupTrace::Event> UniWinStartupTrace::_events;
+std::atomic<int64_t> UniWinStartupTrace::_origin_usec(0);
+std::atomic<bool> UniWinStartupTrace::_finished(false);
+int64_t UniWinStartupTrace::_finish_usec = 0;
+
+UniWinStartupTrace::Scope::Scope(const char* name) :
+        _name(name), _start_usec(is_recording() ? now_usec() : -1) {
+}
+
+UniWinStartupTrace::Scope::~Scope() {
+    if (_start_usec >= 0) {
+        add_phase(_name, _start_usec, now_usec());
+    }
+}
+
+int64_t UniWinStartupTrace::_clock_usec() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t UniWinStartupTrace::_thread_index() {
+    static std::atomic<uint32_t> next_index(1);
+    thread_local uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void UniWinStartupTrace::start() {
+    int64_t expected = 0;
+    _origin_usec.compare_exchange_strong(expected, _clock_usec(), std::memory_order_acq_rel);
+}
+
+int64_t UniWinStartupTrace::now_usec() {
+    start();  // 没有经过gdextension_init（如编辑器热重载）时以第一次使用为原点
+    return _clock_usec() - _origin_usec.load(std::memory_order_acquire);
+}
+
+bool UniWinStartupTrace::is_recording() {
+    return !_finished.load(std::memory_order_acquire);
+}
+
+void UniWinStartupTrace::_record(const std::string& name, int64_t start_usec, int64_t duration_usec) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_finished.load(std::memory_order_relaxed) || (int)_events.size() >= MAX_EVENTS) {
+        return;
+    }
+    Event event;
+    event.name = name;
+    event.start_usec = start_usec;
+    event.duration_usec = duration_usec;
+    event.thread = _thread_index();
+    _events.push_back(std::move(event));
+}
+
+void UniWinStartupTrace::add_phase(const std::string& name, int64_t start_usec, int64_t end_usec) {
+    _record(name, start_usec, std::max<int64_t>(end_usec - start_usec, 0));
+}
+
+void UniWinStartupTrace::mark(const std::string& name) {
+    _record(name, now_usec(), -1);
+}
+
+void UniWinStartupTrace::finish() {
+    int64_t time = now_usec();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_finished.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    _finish_usec = time;
+}
+
+bool UniWinStartupTrace::is_finished() {
+    return _finished.load(std::memory_order_acquire);
+}
+
+int64_t UniWinStartupTrace::from_engine_ticks(int64_t ticks_usec) {
+    // 两个时钟的差在换算时当场测量
+    int64_t offset = now_usec() - (int64_t)Time::get_singleton()->get_ticks_usec();
+    return ticks_usec + offset;
+}
+
+Dictionary UniWinStartupTrace::get_timeline() {
+    std::vector<Event> events;
+    bool finished = false;
+    int64_t total = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        events = _events;
+        finished = _finished.load(std::memory_order_relaxed);
+        total = _finish_usec;
+    }
+    // 作用域在结束时才写入，按开始时间重新排序
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        return a.start_usec < b.start_usec;
+    });
+
+    Array phases;
+    Array marks;
+    for (const Event& event : events) {
+        Dictionary info;
+        info["name"] = String::utf8(event.name.c_str());
+        if (event.duration_usec < 0) {
+            info["time_usec"] = event.start_usec;
+            marks.append(info);
+        } else {
+            info["start_usec"] = event.start_usec;
+            info["duration_usec"] = event.duration_usec;
+            info["thread"] = (int64_t)event.thread;
+            phases.append(info);
+        }
+        if (!finished) {
+            total = std::max(total, event.start_usec + std::max<int64_t>(event.duration_usec, 0));
+        }
+    }
+
+    Dictionary result;
+    result["finished"] = finished;
+    result["total_usec"] = total;
+    result["phases"] = phases;
+    result["marks"] = marks;
+    return result;
+}
+
+String UniWinStartupTrace::get_chrome_trace_json() {
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        events = _events;
+    }
+
+    Array trace_events;
+    Dictionary process_name;
+    Dictionary process_args;
+    process_args["name"] = "UniWinC startup";
+    process_name["name"] = "process_name";
+    process_name["ph"] = "M";
+    process_name["pid"] = 1;
+    process_name["args"] = process_args;
+    trace_events.append(process_name);
+
+    for (const Event& event : events) {
+        Dictionary entry;
+        entry["name"] = String::utf8(event.name.c_str());
+        entry["cat"] = "uniwinc";
+        entry["pid"] = 1;
+        entry["tid"] = (int64_t)event.thread;
+        entry["ts"] = event.start_usec;
+        if (event.duration_usec < 0) {
+            entry["ph"] = "i";
+            entry["s"] = "g";
+        } else {
+            entry["ph"] = "X";
+            entry["dur"] = event.duration_usec;
+        }
+        trace_events.append(entry);
+    }
+
+    Dictionary trace;
+    trace["traceEvents"] = trace_events;
+    trace["displayTimeUnit"] = "ms";
+    return JSON::stringify(trace);
+}
@@ -0,0 +1,75 @@
+#ifndef UNIWINC_STARTUP_TRACE_H
+#define UNIWINC_STARTUP_TRACE_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace godot;
+
+// 启动时间线 - 记录从gdextension_init到窗口设置完成之间各阶段的耗时
+// 时间为相对gdextension_init的微秒数；finish()之后不再记录
+// 可导出为Chrome trace-event JSON，在chrome://tracing或Perfetto中查看
+class UniWinStartupTrace {
+public:
+    static const int MAX_EVENTS = 256;
+
+    struct Event {
+        std::string name;
+        int64_t start_usec = 0;
+        int64_t duration_usec = -1;     // -1为瞬时事件
+        uint32_t thread = 0;            // 按首次记录的顺序编号
+    };
+
+    // 作用域计时：构造时记下开始时间，析构时写入一个完整阶段
+    class Scope {
+    private:
+        const char* _name;
+        int64_t _start_usec;
+
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    static std::mutex _mutex;
+    static std::vector<Event> _events;
+    static std::atomic<int64_t> _origin_usec;   // steady_clock的绝对时间，0为尚未开始
+    static std::atomic<bool> _finished;
+    static int64_t _finish_usec;
+
+    static int64_t _clock_usec();
+    static uint32_t _thread_index();
+    static void _record(const std::string& name, int64_t start_usec, int64_t duration_usec);
+
+public:
+    // 设置时间原点，只有第一次调用有效（gdextension_init中调用）
+    static void start();
+    static int64_t now_usec();
+    static bool is_recording();
+
+    static void add_phase(const std::string& name, int64_t start_usec, int64_t end_usec);
+    static void mark(const std::string& name);
+    // 启动完成（窗口设置已应用），之后的事件被忽略
+    static void finish();
+    static bool is_finished();
+
+    // Time.get_ticks_usec()的值换算为相对原点的时间，供脚本记录的阶段使用
+    static int64_t from_engine_ticks(int64_t ticks_usec);
+
+    // {finished, total_usec, phases: [{name, start_usec, duration_usec, thread}], marks: [{name, time_usec}]}
+    static Dictionary get_timeline();
+    static String get_chrome_trace_json();
+};
+
+#define UNIWINC_TRACE_SCOPE(m_name) UniWinStartupTrace::Scope _uniwinc_trace_scope(m_name)
+
+#endif // UNIWINC_STARTUP_TRACE_H
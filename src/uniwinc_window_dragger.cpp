@@ -0,0 +1,170 @@
+#include "uniwinc_window_dragger.h"
+#include "uniwinc_core.h"
+#include "uniwinc_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace godot;
+
+// native库的鼠标按键和修饰键定义（与Unity版本相同）
+static const int MOUSE_BUTTON_LEFT_MASK = 1;
+
+UniWinWindowDragger::~UniWinWindowDragger() {
+    stop();
+}
+
+bool UniWinWindowDragger::start(const Settings& settings) {
+    stop();
+
+    if (settings.disable_on_zoomed && UniWinCore::query_zoomed()) {
+        return false;
+    }
+    float cursor_x = 0.0f, cursor_y = 0.0f;
+    float window_x = 0.0f, window_y = 0.0f;
+    UniWinCore::get_cursor_position(&cursor_x, &cursor_y);
+    if (!UniWinCore::query_position(&window_x, &window_y)) {
+        UNIWINC_LOG_WARNING(UniWinLog::CATEGORY_INPUT, "Cannot start window drag: GetPosition not available");
+        return false;
+    }
+
+    _settings = settings;
+    _settings.poll_rate = std::max(settings.poll_rate, 1);
+    _cursor_offset = Vector2(cursor_x - window_x, cursor_y - window_y);
+    _predictor.reset();
+    {
+        std::lock_guard<std::mutex> lock(_error_mutex);
+        _error_stats = ErrorStats();
+    }
+    _applied_version = _target_version.load(std::memory_order_acquire);
+    _ended.store(false, std::memory_order_relaxed);
+    _stop.store(false, std::memory_order_relaxed);
+    _running.store(true, std::memory_order_release);
+    _thread = std::thread(&UniWinWindowDragger::_thread_main, this);
+    return true;
+}
+
+void UniWinWindowDragger::stop() {
+    _stop.store(true, std::memory_order_release);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _running.store(false, std::memory_order_release);
+}
+
+bool UniWinWindowDragger::is_dragging() const {
+    return _running.load(std::memory_order_acquire);
+}
+
+bool UniWinWindowDragger::take_ended() {
+    if (!_ended.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+    if (_thread.joinable()) {
+        _thread.join();  // 线程已退出，join立即返回
+    }
+    return true;
+}
+
+bool UniWinWindowDragger::take_target(Vector2* position) {
+    uint32_t version = _target_version.load(std::memory_order_acquire);
+    if (version == _applied_version) {
+        return false;
+    }
+    _applied_version = version;
+    uint64_t packed = _target.load(std::memory_order_acquire);
+    uint32_t bits[2] = { (uint32_t)(packed & 0xFFFFFFFFu), (uint32_t)(packed >> 32) };
+    float xy[2];
+    memcpy(xy, bits, sizeof(xy));
+    *position = Vector2(xy[0], xy[1]);
+    return true;
+}
+
+bool UniWinWindowDragger::update() {
+    if (!is_dragging()) {
+        return true;
+    }
+    if (_settings.disable_on_zoomed && UniWinCore::query_zoomed()) {
+        return false;
+    }
+    // 窗口实际位置与当前光标要求的位置之差
+    float cursor_x = 0.0f, cursor_y = 0.0f;
+    float window_x = 0.0f, window_y = 0.0f;
+    UniWinCore::get_cursor_position(&cursor_x, &cursor_y);
+    if (UniWinCore::query_position(&window_x, &window_y)) {
+        _record_error((Vector2(cursor_x, cursor_y) - _cursor_offset).distance_to(Vector2(window_x, window_y)));
+    }
+    return true;
+}
+
+UniWinWindowDragger::ErrorStats UniWinWindowDragger::get_error_stats() const {
+    std::lock_guard<std::mutex> lock(_error_mutex);
+    return _error_stats;
+}
+
+void UniWinWindowDragger::_record_error(float error) {
+    std::lock_guard<std::mutex> lock(_error_mutex);
+    ErrorStats& stats = _error_stats;
+    stats.samples++;
+    stats.mean += (error - stats.mean) / (double)stats.samples;
+    stats.max = std::max(stats.max, error);
+    stats.last = error;
+}
+
+void UniWinWindowDragger::_publish_target(float x, float y) {
+    float xy[2] = { x, y };
+    uint32_t bits[2];
+    memcpy(bits, xy, sizeof(bits));
+    _target.store((uint64_t)bits[0] | ((uint64_t)bits[1] << 32), std::memory_order_release);
+    _target_version.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void UniWinWindowDragger::_thread_main() {
+    using clock = std::chrono::steady_clock;
+    const clock::duration period = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(1.0 / _settings.poll_rate));
+    const clock::time_point start = clock::now();
+    clock::time_point next = start;
+    float last_x = 0.0f, last_y = 0.0f;
+    bool has_last = false;
+
+    while (!_stop.load(std::memory_order_acquire)) {
+        // 最大化检查在主线程的update()中进行
+        if ((UniWinCore::get_mouse_buttons() & MOUSE_BUTTON_LEFT_MASK) == 0) {
+            _running.store(false, std::memory_order_release);
+            _ended.store(true, std::memory_order_release);
+            return;
+        }
+
+        // 按住修饰键时暂停移动但不结束拖动
+        if (!_settings.pause_on_modifiers || UniWinCore::get_modifier_keys() == 0) {
+            float cursor_x = 0.0f, cursor_y = 0.0f;
+            UniWinCore::get_cursor_position(&cursor_x, &cursor_y);
+            Vector2 cursor(cursor_x, cursor_y);
+
+            double time = std::chrono::duration<double>(clock::now() - start).count();
+            _predictor.add_sample(cursor, time);
+            Vector2 predicted = _predictor.predict(_settings.prediction_horizon,
+                    _settings.prediction_max_distance, _settings.prediction_use_acceleration);
+            float x = predicted.x - _cursor_offset.x;
+            float y = predicted.y - _cursor_offset.y;
+            if (!has_last || x != last_x || y != last_y) {
+                // 平台不支持在线程中移动时交给主线程应用
+                if (!UniWinCore::move_window_from_thread(x, y)) {
+                    _publish_target(x, y);
+                }
+                last_x = x;
+                last_y = y;
+                has_last = true;
+            }
+        }
+
+        next += period;
+        clock::time_point now = clock::now();
+        if (next < now) {
+            next = now;  // 落后时不补采样
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef UNIWINC_WINDOW_DRAGGER_H
+#define UNIWINC_WINDOW_DRAGGER_H
+
+#include "uniwinc_motion_predictor.h"
+
+#include <godot_cpp/variant/vector2.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+using namespace godot;
+
+// 窗口拖动引擎 - 开始后在独立线程按固定频率读取光标并移动窗口，不依赖Godot的帧率
+// 可选的运动预测把窗口移到光标即将到达的位置，抵消窗口系统应用移动的延迟
+// 规则与Unity版本UniWindowMoveHandle一致：左键松开时结束，按住修饰键时暂停，
+// disable_on_zoomed时窗口最大化即结束
+// 线程只读取光标、鼠标按键和修饰键；查询窗口状态（最大化、位置）在主线程的update()中进行，
+// macOS的AppKit不允许在其他线程访问NSWindow
+class UniWinWindowDragger {
+public:
+    struct Settings {
+        int poll_rate = 240;            // 每秒采样次数
+        bool disable_on_zoomed = true;
+        bool pause_on_modifiers = true;
+        double prediction_horizon = 0.0;        // 预测外推的秒数，0为不预测
+        float prediction_max_distance = 48.0f;  // 预测位移上限（像素）
+        bool prediction_use_acceleration = true;
+    };
+
+    // 光标与窗口的偏差：每帧在主线程测量的窗口实际位置与光标对应位置的距离（像素）
+    struct ErrorStats {
+        double mean = 0.0;
+        float max = 0.0f;
+        float last = 0.0f;
+        int64_t samples = 0;
+    };
+
+private:
+    std::thread _thread;
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _ended{false};            // 线程自行结束（松开左键等），等待主线程取走
+    std::atomic<uint64_t> _target{0};           // 最新目标位置（两个float打包，避免读到一半）
+    std::atomic<uint32_t> _target_version{0};
+    uint32_t _applied_version = 0;              // 主线程已应用的版本
+    Settings _settings;
+    Vector2 _cursor_offset;                     // 光标相对窗口位置的偏移（native坐标）
+    UniWinMotionPredictor _predictor;           // 只在拖动线程中使用
+    ErrorStats _error_stats;
+    mutable std::mutex _error_mutex;
+
+public:
+    UniWinWindowDragger() = default;
+    ~UniWinWindowDragger();
+
+    // 以当前光标位置开始拖动（主线程调用）
+    bool start(const Settings& settings);
+    void stop();
+    bool is_dragging() const;
+
+    // 线程是否已自行结束拖动，返回true后复位（主线程调用）
+    bool take_ended();
+
+    // 不能在线程中移动窗口的平台：取得尚未应用的最新目标位置（主线程调用）
+    bool take_target(Vector2* position);
+
+    // 每帧在主线程调用：检查最大化并测量光标与窗口的偏差，窗口最大化需要结束拖动时返回false
+    bool update();
+
+    // 最近一次拖动（或进行中的拖动）的偏差统计
+    ErrorStats get_error_stats() const;
+
+private:
+    void _thread_main();
+    void _publish_target(float x, float y);
+    void _record_error(float error);
+};
+
+#endif // UNIWINC_WINDOW_DRAGGER_H